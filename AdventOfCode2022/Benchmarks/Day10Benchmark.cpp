@@ -0,0 +1,87 @@
+#include "../Challenge/Day10.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <random>
+
+// Programs per second of the batched lanes against evaluating one program at a time.
+// Usage: Day10Benchmark [number of programs] [operations per program]
+// - interpreter: getSumOfSignalStrengths and getScreenAfterOperations on the operations
+// - trace: a CycleTrace per program with getSumOfSignalStrengths and getScreen
+// - batched: evaluatePrograms, laneCount programs at a time
+// Program lengths vary by up to a factor of two, so lanes finish unevenly. Every result is
+// compared against the interpreter after timing.
+namespace
+{
+    std::vector<std::vector<Day10::Operation>> generatePrograms( int64_t numPrograms, int64_t numOperations ) {
+        std::mt19937 random( 46 );
+        std::vector<std::vector<Day10::Operation>> programs( numPrograms );
+        for( auto& program : programs ) {
+            const int64_t length = numOperations / 2 + random() % ( numOperations / 2 + 1 );
+            for( int64_t i = 0; i < length; i++ ) {
+                if( random() % 3 == 0 )
+                    program.push_back( Day10::NOOP{} );
+                else
+                    program.push_back( Day10::AddOperation{ static_cast<int64_t>( random() % 81 ) - 40 } );
+            }
+        }
+        return programs;
+    }
+
+    struct Output
+    {
+        int64_t signalStrengthSum = 0;
+        std::string screen;
+    };
+
+    // Best of 3 runs in programs per second
+    template<typename Evaluate>
+    double measure( int64_t numPrograms, Evaluate evaluate ) {
+        double best = 0;
+        for( int64_t run = 0; run < 3; run++ ) {
+            const auto start = std::chrono::steady_clock::now();
+            evaluate();
+            const auto seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+            if( run == 0 || seconds < best )
+                best = seconds;
+        }
+        return numPrograms / best;
+    }
+}
+
+int main( int argc, char** argv ) {
+    const int64_t numPrograms = argc > 1 ? std::atoll( argv[ 1 ] ) : 20'000;
+    const int64_t numOperations = std::max<int64_t>( argc > 2 ? std::atoll( argv[ 2 ] ) : 140, 1 );
+    const auto programs = generatePrograms( numPrograms, numOperations );
+
+    std::vector<Output> expected( programs.size() );
+    const auto interpreterRate = measure( numPrograms, [&] {
+        for( size_t i = 0; i < programs.size(); i++ )
+            expected[ i ] = { Day10::getSumOfSignalStrengths( programs[ i ] ), Day10::getScreenAfterOperations( programs[ i ] ) };
+    } );
+
+    std::vector<Output> traced( programs.size() );
+    const auto traceRate = measure( numPrograms, [&] {
+        for( size_t i = 0; i < programs.size(); i++ ) {
+            const Day10::CycleTrace trace( programs[ i ] );
+            traced[ i ] = { Day10::getSumOfSignalStrengths( trace ), Day10::getScreen( trace ) };
+        }
+    } );
+
+    std::vector<Day10::ProgramResult> results;
+    const auto batchedRate = measure( numPrograms, [&] { results = Day10::evaluatePrograms( programs ); } );
+
+    int64_t numWrong = 0;
+    for( size_t i = 0; i < programs.size(); i++ ) {
+        numWrong += traced[ i ].signalStrengthSum != expected[ i ].signalStrengthSum || traced[ i ].screen != expected[ i ].screen;
+        numWrong += results[ i ].signalStrengthSum != expected[ i ].signalStrengthSum || Day10::getScreen( results[ i ] ) != expected[ i ].screen;
+    }
+
+    fmt::print( "{} programs of {} to {} operations\n", numPrograms, numOperations / 2, numOperations );
+    fmt::print( "interpreter: {:12.0f} programs/s\n", interpreterRate );
+    fmt::print( "trace:       {:12.0f} programs/s speedup {:5.2f}\n", traceRate, traceRate / interpreterRate );
+    fmt::print( "batched:     {:12.0f} programs/s speedup {:5.2f}\n", batchedRate, batchedRate / interpreterRate );
+    if( numWrong > 0 )
+        fmt::print( "WRONG RESULT for {} programs\n", numWrong );
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include "../Challenge/Day5.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <random>
+
+// Query latency of CargoHistory against its checkpoint interval.
+// Usage: Day5Benchmark [input file] [number of queries]
+// Without an input file a random setup of 9 stacks and 100k moves is used. Every interval
+// answers the same random queries, the checksum column has to agree between the intervals.
+namespace
+{
+    Day5::CargoSetup generateSetup( int64_t numMoves ) {
+        std::mt19937 random( 5 );
+        Day5::CargoSetup setup;
+        setup.cargo.resize( 9 );
+        for( auto& stack : setup.cargo )
+            for( int64_t i = 0; i < 50; i++ )
+                stack.push_back( static_cast<char>( 'A' + random() % 26 ) );
+
+        std::vector<int64_t> heights( setup.cargo.size(), 50 );
+        while( std::ssize( setup.moves ) < numMoves ) {
+            const int64_t from = random() % 9;
+            const int64_t to = ( from + 1 + random() % 8 ) % 9;
+            if( heights[ from ] == 0 )
+                continue;
+            const int64_t count = 1 + random() % std::min<int64_t>( heights[ from ], 20 );
+            setup.moves.push_back( { count, from, to } );
+            heights[ from ] -= count;
+            heights[ to ] += count;
+        }
+        return setup;
+    }
+
+    double getSeconds( std::chrono::steady_clock::time_point start ) {
+        return std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+    }
+}
+
+int main( int argc, char** argv ) {
+    Day5::CargoSetup setup;
+    if( argc > 1 ) {
+        std::ifstream file( argv[ 1 ] );
+        setup = Day5::parseInput( file );
+    }
+    else
+        setup = generateSetup( 100'000 );
+    const int64_t numQueries = argc > 2 ? std::atoll( argv[ 2 ] ) : 10'000;
+
+    int64_t numCrates = 0;
+    for( auto& stack : setup.cargo )
+        numCrates += std::ssize( stack );
+
+    std::mt19937 random( 30 );
+    std::vector<int64_t> queries;
+    for( int64_t i = 0; i < numQueries; i++ )
+        queries.push_back( random() % ( std::ssize( setup.moves ) + 1 ) );
+
+    fmt::print( "{} stacks, {} crates, {} moves, {} queries\n", setup.cargo.size(), numCrates, setup.moves.size(), numQueries );
+    for( int64_t checkpointInterval : { 1, 8, 64, 512, 4096 } ) {
+        auto start = std::chrono::steady_clock::now();
+        const Day5::CargoHistory history( setup, Day5::Crane::CrateMover9001, checkpointInterval );
+        const auto buildSeconds = getSeconds( start );
+
+        start = std::chrono::steady_clock::now();
+        uint64_t checksum = 0;
+        for( auto moveCount : queries )
+            for( auto crate : history.getTopCargoAfter( moveCount ) )
+                checksum = checksum * 31 + crate;
+        const auto querySeconds = getSeconds( start );
+
+        const auto storedCrates = ( std::ssize( setup.moves ) / checkpointInterval + 1 ) * numCrates;
+        fmt::print( "interval {:5}: build {:9.1f} us, query {:8.2f} us, stored crates {:10}, checksum {:016x}\n",
+            checkpointInterval, buildSeconds * 1e6, querySeconds * 1e6 / std::max<int64_t>( numQueries, 1 ), storedCrates, checksum );
+    }
+    return 0;
+}
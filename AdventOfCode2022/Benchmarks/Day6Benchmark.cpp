@@ -0,0 +1,177 @@
+#include "../Challenge/Day6.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <random>
+
+// Usage: Day6Benchmark strategies [size in MiB] [marker size]
+// Compares the incremental window, the skip-ahead search and the strategy chosen from the sample
+// on in-memory signals:
+// - random: uniform letters, the marker is found inside the sample
+// - random 13: letters from a 13 letter alphabet, the marker is the whole alphabet at the end
+// - periodic: "aab" repeated, the skip-ahead search jumps far on every window
+// - worst case: markerSize - 1 distinct letters repeated, every window is rejected by its first
+//   byte only, so the skip-ahead search inspects markerSize bytes per position
+//
+// Usage: Day6Benchmark scaling [signal file] [size in GiB] [marker size]
+// Thread scaling of the parallel marker search on a mapped signal file. The file is generated
+// when it is missing or has a different size. It holds random letters from a 13 letter alphabet,
+// so no window of 14 is unique, followed by the whole alphabet at the very end, which makes
+// every chunk search its whole range.
+namespace
+{
+    constexpr std::string_view signalEnd = "abcdefghijklmnopqrstuvwxyz";
+
+    void generateSignal( const std::filesystem::path& path, int64_t size ) {
+        std::ofstream file( path, std::ios::binary );
+        std::vector<char> buffer( 1 << 20 );
+        uint64_t state = 0x9e3779b97f4a7c15;
+        const auto randomSize = size - std::ssize( signalEnd );
+        for( int64_t written = 0; written < randomSize; ) {
+            const auto count = std::min<int64_t>( std::ssize( buffer ), randomSize - written );
+            for( int64_t i = 0; i < count; i++ ) {
+                state ^= state << 13;
+                state ^= state >> 7;
+                state ^= state << 17;
+                buffer[ i ] = static_cast<char>( 'a' + ( state >> 32 ) % 13 );
+            }
+            file.write( buffer.data(), count );
+            written += count;
+        }
+        file.write( signalEnd.data(), std::ssize( signalEnd ) );
+    }
+
+    double getSeconds( std::chrono::steady_clock::time_point start ) {
+        return std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+    }
+
+    // Serial searches of one signal, the marker of every strategy has to agree
+    bool runStrategies( std::string_view name, std::string_view data, int64_t markerSize ) {
+        struct Strategy
+        {
+            std::string_view name;
+            int64_t ( *search )( std::string_view, int64_t );
+        };
+        constexpr std::array strategies = {
+            Strategy{ "incremental", Day6::getStartPacketMarkerIncremental },
+            Strategy{ "skip ahead", Day6::getStartPacketMarkerSkipAhead },
+            Strategy{ "sampled", Day6::getStartPacketMarker } };
+
+        const auto expected = Day6::getStartPacketMarkerIncremental( data, markerSize );
+        bool isCorrect = true;
+        for( auto& strategy : strategies ) {
+            constexpr int64_t numRuns = 3;
+            double best = 0;
+            int64_t marker = -1;
+            for( int64_t run = 0; run < numRuns; run++ ) {
+                const auto start = std::chrono::steady_clock::now();
+                marker = strategy.search( data, markerSize );
+                const auto seconds = getSeconds( start );
+                if( run == 0 || seconds < best )
+                    best = seconds;
+            }
+
+            isCorrect &= marker == expected;
+            fmt::print( "{:10} {:11}: marker {:10} {:12.1f} us {:8.1f} MiB/s{}\n", name, strategy.name, marker, best * 1e6,
+                std::max<int64_t>( marker, 0 ) / best / ( 1 << 20 ), marker == expected ? "" : " WRONG MARKER" );
+        }
+        return isCorrect;
+    }
+
+    std::string generateRandomSignal( int64_t size, int64_t alphabetSize ) {
+        std::mt19937 random( 6 );
+        std::string data( size, 'a' );
+        for( auto& letter : data )
+            letter = static_cast<char>( 'a' + random() % alphabetSize );
+        return data;
+    }
+
+    std::string generatePeriodicSignal( int64_t size, std::string_view period ) {
+        std::string data;
+        data.reserve( size );
+        while( std::ssize( data ) < size )
+            data += period;
+        data.resize( size );
+        return data;
+    }
+
+    int runStrategies( int64_t size, int64_t markerSize ) {
+        // Throughput is measured up to the marker, so every signal except the first one ends with it
+        auto withMarker = [&] ( std::string data ) {
+            data.replace( data.size() - signalEnd.size(), signalEnd.size(), signalEnd );
+            return data;
+        };
+
+        fmt::print( "Signals of {} MiB, marker size {}\n", size >> 20, markerSize );
+        bool isCorrect = runStrategies( "random", generateRandomSignal( size, 26 ), markerSize );
+        isCorrect &= runStrategies( "random 13", withMarker( generateRandomSignal( size, 13 ) ), markerSize );
+        isCorrect &= runStrategies( "periodic", withMarker( generatePeriodicSignal( size, "aab" ) ), markerSize );
+        isCorrect &= runStrategies( "worst case", withMarker( generatePeriodicSignal( size, signalEnd.substr( 0, markerSize - 1 ) ) ), markerSize );
+        return isCorrect ? 0 : 1;
+    }
+
+    int runScaling( const std::filesystem::path& path, int64_t size, int64_t markerSize ) {
+        if( !std::filesystem::exists( path ) || static_cast<int64_t>( std::filesystem::file_size( path ) ) != size ) {
+            fmt::print( "Generating {:.1f} GiB signal in {}\n", size / double( int64_t( 1 ) << 30 ), path.string() );
+            generateSignal( path, size );
+        }
+
+        const Day6::MappedFile file( path );
+        const auto data = file.getData();
+        // Only the end of the signal can hold a marker, so the serial search there is the reference
+        const int64_t endStart = std::max<int64_t>( size - 4096, 0 );
+        const int64_t expected = endStart + Day6::getStartPacketMarker( data.substr( endStart ), markerSize );
+
+        // Untimed pass to fault the mapping in, as far as the page cache allows
+        Day6::getStartPacketMarkerParallel( data, markerSize );
+
+        const int64_t maxThreads = std::max<int64_t>( std::thread::hardware_concurrency(), 1 );
+        std::vector<int64_t> threadCounts;
+        for( int64_t numThreads = 1; numThreads < maxThreads; numThreads *= 2 )
+            threadCounts.push_back( numThreads );
+        threadCounts.push_back( maxThreads );
+
+        bool isCorrect = true;
+        double serialSeconds = 0;
+        for( auto numThreads : threadCounts ) {
+            const auto start = std::chrono::steady_clock::now();
+            const auto marker = Day6::getStartPacketMarkerParallel( data, markerSize, numThreads );
+            const auto seconds = getSeconds( start );
+            if( numThreads == 1 )
+                serialSeconds = seconds;
+
+            isCorrect &= marker == expected;
+            fmt::print( "threads {:3}: {:8.3f} s {:7.2f} GiB/s speedup {:5.2f}{}\n", numThreads, seconds,
+                size / seconds / ( int64_t( 1 ) << 30 ), serialSeconds / seconds, marker == expected ? "" : " WRONG MARKER" );
+        }
+        return isCorrect ? 0 : 1;
+    }
+}
+
+int main( int argc, char** argv ) {
+    const std::string_view mode = argc > 1 ? argv[ 1 ] : "";
+    if( mode == "strategies" ) {
+        const int64_t size = static_cast<int64_t>( ( argc > 2 ? std::atof( argv[ 2 ] ) : 64.0 ) * ( 1 << 20 ) );
+        const int64_t markerSize = argc > 3 ? std::atoll( argv[ 3 ] ) : 14;
+        if( markerSize < 2 || markerSize > 26 || size < std::ssize( signalEnd ) ) {
+            fmt::print( "marker size must be between 2 and 26\n" );
+            return 1;
+        }
+        return runStrategies( size, markerSize );
+    }
+
+    if( mode == "scaling" ) {
+        const std::filesystem::path path = argc > 2 ? argv[ 2 ] : "day6_signal.txt";
+        const int64_t size = static_cast<int64_t>( ( argc > 3 ? std::atof( argv[ 3 ] ) : 10.0 ) * ( int64_t( 1 ) << 30 ) );
+        const int64_t markerSize = argc > 4 ? std::atoll( argv[ 4 ] ) : 14;
+        if( markerSize < 14 || markerSize > 26 ) {
+            fmt::print( "marker size must be between 14 and 26\n" );
+            return 1;
+        }
+        return runScaling( path, size, markerSize );
+    }
+
+    fmt::print( "Usage: Day6Benchmark strategies [size in MiB] [marker size]\n" );
+    fmt::print( "       Day6Benchmark scaling [signal file] [size in GiB] [marker size]\n" );
+    return 1;
+}
@@ -0,0 +1,117 @@
+#include "../Challenge/Day7.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <random>
+
+// Thread scaling of the fused size aggregation on generated trees.
+// Usage: Day7Benchmark [number of directories] [max threads]
+// - wide: the root holds 1000 empty directories and one directory with all the others below it
+// - bushy: every directory has a random earlier directory as parent
+// - deep: 16 chains below the root
+// Every thread count is compared against one thread, the results have to agree.
+namespace
+{
+    // Tree from a parent array with parents[ i ] < i, listed depth first with one file per directory
+    Day7::FlatTree buildTree( const std::vector<int64_t>& parents ) {
+        std::vector<std::vector<int64_t>> children( parents.size() );
+        for( int64_t directory = 1; directory < std::ssize( parents ); directory++ )
+            children[ parents[ directory ] ].push_back( directory );
+
+        std::mt19937 random( 7 );
+        Day7::FlatTreeBuilder builder;
+        auto listDirectory = [&] ( int64_t directory ) {
+            builder.listDirectory();
+            for( auto child : children[ directory ] )
+                builder.addListedDirectory( fmt::format( "d{}", child ) );
+            builder.addListedFile( "f.txt", random() % 100'000 );
+        };
+
+        listDirectory( 0 );
+        std::vector<std::pair<int64_t, size_t>> stack{ { 0, 0 } };
+        while( !stack.empty() ) {
+            auto& [directory, nextChild] = stack.back();
+            if( nextChild == children[ directory ].size() ) {
+                stack.pop_back();
+                if( !stack.empty() )
+                    builder.changeDirectory( ".." );
+                continue;
+            }
+
+            const auto child = children[ directory ][ nextChild++ ];
+            builder.changeDirectory( fmt::format( "d{}", child ) );
+            listDirectory( child );
+            stack.push_back( { child, 0 } );
+        }
+        return builder.build();
+    }
+
+    std::vector<int64_t> getWideParents( int64_t numDirectories ) {
+        std::mt19937 random( 36 );
+        constexpr int64_t numLeaves = 1000;
+        std::vector<int64_t> parents( numLeaves + 2, 0 );
+        for( int64_t directory = numLeaves + 2; directory < numDirectories; directory++ )
+            parents.push_back( numLeaves + 1 + random() % ( directory - numLeaves - 1 ) );
+        return parents;
+    }
+
+    std::vector<int64_t> getBushyParents( int64_t numDirectories ) {
+        std::mt19937 random( 37 );
+        std::vector<int64_t> parents( 1, 0 );
+        for( int64_t directory = 1; directory < numDirectories; directory++ )
+            parents.push_back( random() % directory );
+        return parents;
+    }
+
+    std::vector<int64_t> getDeepParents( int64_t numDirectories ) {
+        constexpr int64_t numChains = 16;
+        std::vector<int64_t> parents( 1, 0 );
+        for( int64_t directory = 1; directory < numDirectories; directory++ )
+            parents.push_back( directory <= numChains ? 0 : directory - numChains );
+        return parents;
+    }
+
+    void runScaling( std::string_view name, Day7::FlatTree& tree, const std::vector<int64_t>& threadCounts ) {
+        const Day7::SizeQuery query = { 100'000, Day7::getTotalFileSize( tree ) / 3 };
+
+        Day7::SizeSummary expected;
+        double serialSeconds = 0;
+        for( auto numThreads : threadCounts ) {
+            constexpr int64_t numRuns = 3;
+            double best = 0;
+            Day7::SizeSummary summary;
+            for( int64_t run = 0; run < numRuns; run++ ) {
+                const auto start = std::chrono::steady_clock::now();
+                summary = Day7::aggregateDirectorySizes( tree, query, numThreads );
+                const auto seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+                if( run == 0 || seconds < best )
+                    best = seconds;
+            }
+            if( numThreads == 1 ) {
+                expected = summary;
+                serialSeconds = best;
+            }
+
+            const bool isCorrect = summary.sumOfDirectories == expected.sumOfDirectories && summary.sizeOfDeletedDirectory == expected.sizeOfDeletedDirectory;
+            fmt::print( "{:5} threads {:3}: {:8.2f} ms speedup {:5.2f}{}\n", name, numThreads, best * 1000, serialSeconds / best, isCorrect ? "" : " WRONG RESULT" );
+        }
+    }
+}
+
+int main( int argc, char** argv ) {
+    const int64_t numDirectories = std::max<int64_t>( argc > 1 ? std::atoll( argv[ 1 ] ) : 1'000'000, 1100 );
+    const int64_t maxThreads = argc > 2 ? std::atoll( argv[ 2 ] ) : std::max<int64_t>( std::thread::hardware_concurrency(), 1 );
+
+    std::vector<int64_t> threadCounts;
+    for( int64_t numThreads = 1; numThreads < maxThreads; numThreads *= 2 )
+        threadCounts.push_back( numThreads );
+    threadCounts.push_back( maxThreads );
+
+    fmt::print( "{} directories, hardware threads {}\n", numDirectories, std::thread::hardware_concurrency() );
+    using GetParents = std::vector<int64_t> ( * )( int64_t );
+    for( auto [name, getParents] : { std::pair<std::string_view, GetParents>{ "wide", getWideParents }, { "bushy", getBushyParents }, { "deep", getDeepParents } } ) {
+        auto tree = buildTree( getParents( numDirectories ) );
+        runScaling( name, tree, threadCounts );
+    }
+    return 0;
+}
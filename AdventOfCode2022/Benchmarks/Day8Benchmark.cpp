@@ -0,0 +1,121 @@
+#include "../Challenge/Day8.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <random>
+
+// Strong scaling of the parallel visibility and scenic score passes on a random square map.
+// Usage: Day8Benchmark [map size] [max threads] [number of edits]
+// Every thread count is compared against the serial passes, speedup is serial time divided by
+// parallel time. The work column is the process CPU time relative to the serial run, which
+// shows the overhead of the band summaries independently of the number of cores.
+// Afterwards a stream of random height edits is applied to a ForestModel of the same map and
+// the time per edit is compared against recalculating the whole map.
+namespace
+{
+    Day8::TreeMap generateMap( int64_t size ) {
+        std::mt19937 random( 8 );
+        Day8::TreeMap treeMap;
+        std::string line( size, '0' );
+        for( int64_t y = 0; y < size; y++ ) {
+            for( auto& tree : line )
+                tree = static_cast<char>( '0' + random() % Day8::numTreeHeights );
+            treeMap.addLine( line );
+        }
+        return treeMap;
+    }
+
+    struct Timing
+    {
+        double seconds = 0;
+        double cpuSeconds = 0;
+        int64_t result = 0;
+    };
+
+    template<typename Function>
+    Timing measure( Function function ) {
+        constexpr int64_t numRuns = 3;
+        Timing best;
+        for( int64_t run = 0; run < numRuns; run++ ) {
+            const auto cpuStart = std::clock();
+            const auto start = std::chrono::steady_clock::now();
+            const auto result = function();
+            const Timing timing = {
+                std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count(),
+                double( std::clock() - cpuStart ) / CLOCKS_PER_SEC,
+                result };
+            if( run == 0 || timing.seconds < best.seconds )
+                best = timing;
+        }
+        return best;
+    }
+
+    template<typename Serial, typename Parallel>
+    bool runScaling( std::string_view name, const std::vector<int64_t>& threadCounts, Serial serial, Parallel parallel ) {
+        const auto serialTiming = measure( serial );
+        fmt::print( "{} serial: {:8.1f} ms\n", name, serialTiming.seconds * 1000 );
+
+        bool isCorrect = true;
+        for( auto numThreads : threadCounts ) {
+            const auto timing = measure( [&] () { return parallel( numThreads ); } );
+            isCorrect &= timing.result == serialTiming.result;
+            fmt::print( "{} threads {:3}: {:8.1f} ms speedup {:5.2f} work {:5.2f}{}\n", name, numThreads, timing.seconds * 1000,
+                serialTiming.seconds / timing.seconds, timing.cpuSeconds / serialTiming.cpuSeconds,
+                timing.result == serialTiming.result ? "" : " WRONG RESULT" );
+        }
+        return isCorrect;
+    }
+
+    bool runEdits( const Day8::TreeMap& treeMap, int64_t numEdits ) {
+        const auto recalculation = measure( [&] () {
+            return Day8::calculateVisibility( treeMap ).count() + Day8::calculateScenicScores( treeMap ).maxScore;
+        } );
+
+        auto start = std::chrono::steady_clock::now();
+        Day8::ForestModel model( treeMap );
+        const auto buildSeconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+
+        std::mt19937 random( 41 );
+        auto editedMap = treeMap;
+        start = std::chrono::steady_clock::now();
+        for( int64_t edit = 0; edit < numEdits; edit++ ) {
+            const Day8::Vec2 pos = { static_cast<int64_t>( random() % treeMap.getWidth() ), static_cast<int64_t>( random() % treeMap.getHeight() ) };
+            const auto treeHeight = static_cast<char>( random() % Day8::numTreeHeights );
+            model.setHeight( pos, treeHeight );
+            editedMap.set( pos, treeHeight );
+        }
+        const auto editSeconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count() / std::max<int64_t>( numEdits, 1 );
+
+        const bool isCorrect = model.getNumVisibleTrees() == Day8::calculateVisibility( editedMap ).count()
+            && model.getMaxTreeScore() == Day8::calculateScenicScores( editedMap ).maxScore;
+        fmt::print( "edits: model build {:8.1f} ms, {:8.1f} us per edit, recalculation {:8.1f} ms, {} edits per recalculation{}\n",
+            buildSeconds * 1000, editSeconds * 1e6, recalculation.seconds * 1000, static_cast<int64_t>( recalculation.seconds / editSeconds ),
+            isCorrect ? "" : " WRONG RESULT" );
+        return isCorrect;
+    }
+}
+
+int main( int argc, char** argv ) {
+    const int64_t size = argc > 1 ? std::atoll( argv[ 1 ] ) : 6000;
+    const int64_t maxThreads = argc > 2 ? std::atoll( argv[ 2 ] ) : std::max<int64_t>( std::thread::hardware_concurrency(), 1 );
+    const int64_t numEdits = argc > 3 ? std::atoll( argv[ 3 ] ) : 1000;
+
+    std::vector<int64_t> threadCounts;
+    for( int64_t numThreads = 1; numThreads < maxThreads; numThreads *= 2 )
+        threadCounts.push_back( numThreads );
+    threadCounts.push_back( maxThreads );
+
+    const auto treeMap = generateMap( size );
+    fmt::print( "Map {} x {}, hardware threads {}\n", size, size, std::thread::hardware_concurrency() );
+
+    bool isCorrect = runScaling( "visibility", threadCounts,
+        [&] () { return Day8::calculateVisibility( treeMap ).count(); },
+        [&] ( int64_t numThreads ) { return Day8::calculateVisibilityParallel( treeMap, numThreads ).count(); } );
+    isCorrect &= runScaling( "max score ", threadCounts,
+        [&] () { return Day8::calculateScenicScores( treeMap ).maxScore; },
+        [&] ( int64_t numThreads ) { return Day8::getMaxTreeScoreParallel( treeMap, numThreads ); } );
+    isCorrect &= runEdits( treeMap, numEdits );
+
+    return isCorrect ? 0 : 1;
+}
@@ -10,6 +10,9 @@
 #include <set>
 #include <optional>
 #include <variant>
+#include <span>
+#include <array>
+#include <stdexcept>
 
 namespace Day10
 {
@@ -103,11 +106,168 @@ namespace Day10
         return screen;
     }
 
+    // Value of X during every cycle, compiled once from the program so queries do not
+    // have to interpret the operations again.
+    class CycleTrace
+    {
+        public:
+        explicit CycleTrace( const std::vector<Operation>& operations ) {
+            int64_t X = 1;
+            for( auto& operation : operations ) {
+                const auto previousX = static_cast<int32_t>( X );
+                const auto cyclesExecuted = std::visit( [ &X ] ( auto& operation ) {
+                    return executeCommand( operation, X );
+                    }, operation );
+
+                values.insert( values.end(), cyclesExecuted, previousX );
+            }
+            finalX = static_cast<int32_t>( X );
+        }
+
+        int64_t getNumCycles() const {
+            return std::ssize( values );
+        }
+
+        // X during the given cycle, cycles start at 1. After the last cycle X keeps the value
+        // the program left it at.
+        int64_t getX( int64_t cycle ) const {
+            if( cycle < 1 )
+                throw std::runtime_error( "invalid cycle" );
+            if( cycle > getNumCycles() )
+                return finalX;
+            return values[ cycle - 1 ];
+        }
+
+        int64_t getSignalStrength( int64_t cycle ) const {
+            return Day10::getSignalStrength( cycle, getX( cycle ) );
+        }
+
+        private:
+        std::vector<int32_t> values;
+        int32_t finalX = 1;
+    };
+
+    int64_t getSumOfSignalStrengths( const CycleTrace& trace, std::span<const int64_t> cycles ) {
+        return ranges::accumulate( cycles, 0ll, ranges::plus(), [&] ( int64_t cycle ) { return trace.getSignalStrength( cycle ); } );
+    }
+
+    int64_t getSumOfSignalStrengths( const CycleTrace& trace ) {
+        constexpr int64_t checkDelta = 40;
+        const auto checkCycles = ranges::views::iota( 0ll, ( trace.getNumCycles() + checkDelta - 20 ) / checkDelta )
+            | ranges::views::transform( [] ( int64_t i ) { return int64_t( 20 + i * checkDelta ); } )
+            | ranges::to_vector;
+
+        return getSumOfSignalStrengths( trace, checkCycles );
+    }
+
+    std::string getScreen( const CycleTrace& trace ) {
+        std::string screen;
+        for( int64_t cycle = 1; cycle <= trace.getNumCycles(); cycle++ ) {
+            if( ( cycle - 1 ) % screenWidth == 0 )
+                screen += '\n';
+            screen += getScreenValue( cycle, trace.getX( cycle ) );
+        }
+        return screen;
+    }
+
+    struct ProgramResult
+    {
+        int64_t numCycles = 0;
+        int64_t signalStrengthSum = 0;
+        std::vector<uint64_t> screenRows; // bit i of a row is pixel i
+    };
+
+    std::string getScreen( const ProgramResult& result ) {
+        std::string screen;
+        for( int64_t cycle = 1; cycle <= result.numCycles; cycle++ ) {
+            const auto pixelPos = ( cycle - 1 ) % screenWidth;
+            if( pixelPos == 0 )
+                screen += '\n';
+            screen += result.screenRows[ ( cycle - 1 ) / screenWidth ] >> pixelPos & 1 ? char( 219 ) : ' ';
+        }
+        return screen;
+    }
+
+    // Runs a batch of programs in lockstep, one lane per program. Each program is first
+    // turned into the X delta applied at the end of every cycle, after that all lanes share
+    // the same cycle and pixel position and the per-cycle loop over the lanes is branch-free
+    // 32 bit arithmetic, so the compiler can vectorize it. Lanes past their last cycle keep
+    // their final X, their pixels are masked off when a row is stored.
+    constexpr int64_t laneCount = 16;
+
+    void evaluateBatch( std::span<const std::vector<Operation>> programs, std::span<ProgramResult> results ) {
+        if( programs.empty() )
+            return;
+
+        // Every operation takes at most two cycles, which bounds the deltas of the batch.
+        const auto maxOperations = ranges::max( programs | ranges::views::transform( [] ( const auto& program ) { return std::ssize( program ); } ) );
+        std::vector<int32_t> deltas( 2 * maxOperations * laneCount );
+        std::array<int64_t, laneCount> numCycles = {};
+        for( int64_t lane = 0; lane < std::ssize( programs ); lane++ ) {
+            int64_t cycle = 0;
+            for( auto& operation : programs[ lane ] ) {
+                if( auto add = std::get_if<AddOperation>( &operation ) )
+                    deltas[ ++cycle * laneCount + lane ] = static_cast<int32_t>( add->value );
+                cycle++;
+            }
+            numCycles[ lane ] = cycle;
+            results[ lane ].screenRows.reserve( ( cycle + screenWidth - 1 ) / screenWidth );
+        }
+
+        const auto maxCycles = ranges::max( numCycles );
+
+        std::array<int32_t, laneCount> X;
+        X.fill( 1 );
+        std::array<int64_t, laneCount> signalStrengthSums = {};
+        std::array<uint64_t, laneCount> rowBits = {};
+        for( int64_t cycle = 1; cycle <= maxCycles; cycle++ ) {
+            const auto pixelPos = static_cast<int32_t>( ( cycle - 1 ) % screenWidth );
+            const auto* cycleDeltas = deltas.data() + ( cycle - 1 ) * laneCount;
+
+            // Once per row, so it stays out of the vectorized loop
+            if( cycle % screenWidth == 20 )
+                for( int64_t lane = 0; lane < laneCount; lane++ )
+                    if( cycle <= numCycles[ lane ] )
+                        signalStrengthSums[ lane ] += getSignalStrength( cycle, X[ lane ] );
+
+            for( int64_t lane = 0; lane < laneCount; lane++ ) {
+                const uint64_t isLit = static_cast<uint32_t>( X[ lane ] - pixelPos + 1 ) <= 2;
+                rowBits[ lane ] |= isLit << pixelPos;
+                X[ lane ] += cycleDeltas[ lane ];
+            }
+
+            if( pixelPos == screenWidth - 1 || cycle == maxCycles ) {
+                const auto rowStart = cycle - pixelPos;
+                for( int64_t lane = 0; lane < std::ssize( programs ); lane++ ) {
+                    const auto numPixels = std::min( numCycles[ lane ] - rowStart + 1, screenWidth );
+                    if( numPixels > 0 )
+                        results[ lane ].screenRows.push_back( rowBits[ lane ] & ( ( 1ull << numPixels ) - 1 ) );
+                }
+                rowBits.fill( 0 );
+            }
+        }
+
+        for( int64_t lane = 0; lane < std::ssize( programs ); lane++ ) {
+            results[ lane ].numCycles = numCycles[ lane ];
+            results[ lane ].signalStrengthSum = signalStrengthSums[ lane ];
+        }
+    }
+
+    std::vector<ProgramResult> evaluatePrograms( std::span<const std::vector<Operation>> programs ) {
+        std::vector<ProgramResult> results( programs.size() );
+        for( int64_t batch = 0; batch < std::ssize( programs ); batch += laneCount ) {
+            const auto batchSize = std::min( laneCount, std::ssize( programs ) - batch );
+            evaluateBatch( programs.subspan( batch, batchSize ), std::span( results ).subspan( batch, batchSize ) );
+        }
+        return results;
+    }
+
     void execute() {
         std::ifstream file( "input/Day10.txt" );
         auto operations = parseInput( file );
+        const CycleTrace trace( operations );
 
-        fmt::print( "Day 10: Sum of signal strengths: {}\n", getSumOfSignalStrengths( operations ) );
-        fmt::print( "Day 10: Screen after execution:\n{}\n", getScreenAfterOperations( operations ) );
+        fmt::print( "Day 10: Sum of signal strengths: {}\n", getSumOfSignalStrengths( trace ) );
+        fmt::print( "Day 10: Screen after execution:\n{}\n", getScreen( trace ) );
     }
 }
\ No newline at end of file
@@ -11,15 +11,47 @@
 #include <set>
 #include <optional>
 #include <functional>
+#include <bit>
+#include <limits>
+#include <atomic>
+#include <thread>
+#include <span>
+#include <numeric>
+#include <stdexcept>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 namespace Day11
 {
+    enum class OperationKind
+    {
+        Add,
+        Multiply,
+        Square
+    };
+
+    struct Operation
+    {
+        OperationKind kind;
+        int64_t constant = 0;
+    };
+
+    struct Test
+    {
+        int64_t testValue;
+        int64_t trueMonkey;
+        int64_t falseMonkey;
+    };
+
     struct Monkey
     {
         std::vector<int64_t> items;
         std::function<int64_t( int64_t )> getNewItemValue;
         std::function<int64_t( int64_t )> getMonkey;
         int64_t testValue;
+        Operation operation;
+        Test test;
     };
 
     std::vector<int64_t> parseItems( std::istream& stream ) {
@@ -48,7 +80,18 @@ namespace Day11
         return [ constant ] ( int64_t value ) { return value * constant; };
     }
 
-    std::function<int64_t( int64_t )> parseOperation( std::istream& stream ) {
+    std::function<int64_t( int64_t )> getOperationFunction( const Operation& operation ) {
+        switch( operation.kind ) {
+        case OperationKind::Add:
+            return getAddConstantOperation( operation.constant );
+        case OperationKind::Multiply:
+            return getMultiplyConstantOperation( operation.constant );
+        default:
+            return getSquareOperation();
+        }
+    }
+
+    Operation parseOperation( std::istream& stream ) {
         std::string operationString;
         std::getline( stream, operationString );
 
@@ -61,15 +104,24 @@ namespace Day11
             | ranges::to_vector;
 
         if( splitOperations[2] == "old" )
-            return getSquareOperation();
+            return { OperationKind::Square };
 
         if( splitOperations[1][0] == '+' )
-            return getAddConstantOperation( std::stoll( splitOperations[ 2 ] ) );
+            return { OperationKind::Add, std::stoll( splitOperations[ 2 ] ) };
+
+        return { OperationKind::Multiply, std::stoll( splitOperations[ 2 ] ) };
+    }
+
+    std::function<int64_t( int64_t )> getTestFunction( const Test& test ) {
+        return [ = ]( int64_t value ) {
+            if( value % test.testValue == 0 )
+                return test.trueMonkey;
 
-        return getMultiplyConstantOperation( std::stoll( splitOperations[ 2 ] ) );
+            return test.falseMonkey;
+        };
     }
 
-    std::pair<std::function<int64_t( int64_t )>, int64_t> parseTest( std::istream& stream ) {
+    Test parseTest( std::istream& stream ) {
         std::string testString;
         std::getline( stream, testString );
         int64_t testValue = std::stoll( testString.substr( 21 ) );
@@ -78,22 +130,18 @@ namespace Day11
         std::getline( stream, testString );
         int64_t falseMonkey = std::stoll( testString.substr( 30 ) );
 
-        return { [ = ]( int64_t value ) {
-            if( value % testValue == 0 )
-                return trueMonkey;
-
-            return falseMonkey;
-        }, testValue };
+        return { testValue, trueMonkey, falseMonkey };
     }
 
     Monkey parseMonkey( std::istream& stream ) {
         Monkey monkey;
 
         monkey.items = parseItems( stream );
-        monkey.getNewItemValue = parseOperation( stream );
-        auto [getMonkey, testValue] = parseTest( stream );
-        monkey.getMonkey = std::move( getMonkey );
-        monkey.testValue = testValue;
+        monkey.operation = parseOperation( stream );
+        monkey.test = parseTest( stream );
+        monkey.getNewItemValue = getOperationFunction( monkey.operation );
+        monkey.getMonkey = getTestFunction( monkey.test );
+        monkey.testValue = monkey.test.testValue;
 
         return monkey;
     }
@@ -143,13 +191,489 @@ namespace Day11
         return ranges::accumulate( monkeys, 1ll, std::multiplies(), &Monkey::testValue );
     }
 
+    // Exact divisibility test without a division: for d = 2^k * odd, x is divisible by d iff
+    // rotr( x * inverse( odd ), k ) <= max / d, see Hacker's Delight 10-17.
+    struct DivisibilityTest
+    {
+        uint64_t inverse = 1;
+        uint64_t limit = 0;
+        int32_t shift = 0;
+
+        explicit DivisibilityTest( int64_t divisor = 1 ) {
+            const auto d = static_cast<uint64_t>( divisor );
+            shift = std::countr_zero( d );
+            const auto odd = d >> shift;
+            // Newton iteration, each step doubles the number of correct low bits
+            inverse = odd;
+            for( int i = 0; i < 5; i++ )
+                inverse *= 2 - odd * inverse;
+            limit = std::numeric_limits<uint64_t>::max() / d;
+        }
+
+        bool isDivisible( int64_t value ) const {
+            return std::rotr( static_cast<uint64_t>( value ) * inverse, shift ) <= limit;
+        }
+    };
+
+    // High 64 bits of a 64 x 64 bit product
+    inline uint64_t multiplyHigh( uint64_t a, uint64_t b ) {
+#if defined( _MSC_VER ) && defined( _M_X64 )
+        return __umulh( a, b );
+#elif defined( __SIZEOF_INT128__ )
+        return static_cast<uint64_t>( ( static_cast<unsigned __int128>( a ) * b ) >> 64 );
+#else
+        const uint64_t aLow = a & 0xffffffff, aHigh = a >> 32;
+        const uint64_t bLow = b & 0xffffffff, bHigh = b >> 32;
+        const uint64_t lowLow = aLow * bLow;
+        const uint64_t middle = aHigh * bLow + ( lowLow >> 32 );
+        const uint64_t middle2 = aLow * bHigh + ( middle & 0xffffffff );
+        return aHigh * bHigh + ( middle >> 32 ) + ( middle2 >> 32 );
+#endif
+    }
+
+    struct Wide
+    {
+        uint64_t high;
+        uint64_t low;
+
+        bool operator==( const Wide& ) const = default;
+    };
+
+    // Decimal digits of a 128 bit value, dividing by ten in 32 bit steps
+    std::string toString( Wide value ) {
+        std::string digits;
+        do {
+            uint64_t remainder = value.high % 10;
+            value.high /= 10;
+            uint64_t part = remainder << 32 | value.low >> 32;
+            const auto quotientHigh = part / 10;
+            part = part % 10 << 32 | ( value.low & 0xffffffff );
+            value.low = quotientHigh << 32 | part / 10;
+            digits += static_cast<char>( '0' + part % 10 );
+        } while( value.high != 0 || value.low != 0 );
+
+        ranges::reverse( digits );
+        return digits;
+    }
+
+    // Barrett reduction of 128 bit values: with mu = floor( ( 2^128 - 1 ) / m ), the quotient
+    // estimate from the three upper partial products of x * mu is at most five too small, so a
+    // few subtractions finish the remainder. Keeping m below 2^61 keeps the estimate's remainder
+    // in 64 bits.
+    class BarrettReducer
+    {
+    public:
+        static constexpr uint64_t maxModulus = uint64_t( 1 ) << 61;
+
+        explicit BarrettReducer( uint64_t modulus ) : modulus( modulus ) {
+            if( modulus == 0 || modulus > maxModulus )
+                throw std::runtime_error( "invalid modulus" );
+
+            // Long division of 2^128 - 1, only done once per modulus
+            uint64_t remainder = 0;
+            for( int bit = 127; bit >= 0; bit-- ) {
+                remainder = remainder * 2 + 1;
+                if( remainder >= modulus ) {
+                    remainder -= modulus;
+                    ( bit >= 64 ? muHigh : muLow ) |= uint64_t( 1 ) << ( bit % 64 );
+                }
+            }
+        }
+
+        uint64_t getModulus() const {
+            return modulus;
+        }
+
+        uint64_t reduce( Wide value ) const {
+            const auto quotient = value.high * muHigh + multiplyHigh( value.high, muLow ) + multiplyHigh( value.low, muHigh );
+            auto remainder = value.low - quotient * modulus;
+            while( remainder >= modulus )
+                remainder -= modulus;
+            return remainder;
+        }
+
+        uint64_t multiply( uint64_t a, uint64_t b ) const {
+            return reduce( { multiplyHigh( a, b ), a * b } );
+        }
+
+    private:
+        uint64_t modulus;
+        uint64_t muHigh = 0;
+        uint64_t muLow = 0;
+    };
+
+    struct MonkeyRule
+    {
+        OperationKind kind;
+        int64_t constant;
+        int64_t testValue;
+        int32_t trueMonkey;
+        int32_t falseMonkey;
+        DivisibilityTest test;
+        int64_t divisorIndex;
+    };
+
+    // The exact new worry level, which always fits in 128 bits
+    inline Wide applyOperation( const MonkeyRule& rule, uint64_t value ) {
+        const auto constant = static_cast<uint64_t>( rule.constant );
+        switch( rule.kind ) {
+        case OperationKind::Add:
+            return { value + constant < value, value + constant };
+        case OperationKind::Multiply:
+            return { multiplyHigh( value, constant ), value * constant };
+        default:
+            return { multiplyHigh( value, value ), value * value };
+        }
+    }
+
+    // Product or least common multiple of the test values, empty once it would not fit a reducer
+    inline std::optional<uint64_t> getCombinedModulus( std::span<const MonkeyRule> rules, bool useLcm ) {
+        uint64_t combined = 1;
+        for( auto& rule : rules ) {
+            const auto testValue = static_cast<uint64_t>( rule.testValue );
+            const auto factor = useLcm ? testValue / std::gcd( combined, testValue ) : testValue;
+            if( factor > BarrettReducer::maxModulus / combined )
+                return std::nullopt;
+            combined *= factor;
+        }
+        return combined;
+    }
+
+    // Monkeys compiled into a flat rule table. Items live in one ring buffer per monkey, all
+    // preallocated to the total number of items, so the rounds do not allocate.
+    //
+    // Worry levels are kept modulo the least common multiple of the test values, which keeps
+    // every test result. The division by three needs floor( x / 3 ) mod P for the product P of
+    // the test values, like the reference, which is floor( ( x mod 3P ) / 3 ). When the modulus
+    // does not fit, the worry levels are kept as one residue per distinct test value instead.
+    //
+    // That fallback only works without the division: floor( x / 3 ) mod d is not a function of
+    // x mod d, so part one needs 3P to fit below 2^61 and throws otherwise.
+    class MonkeyProgram
+    {
+    public:
+        explicit MonkeyProgram( const std::vector<Monkey>& monkeys ) {
+            for( auto& monkey : monkeys ) {
+                if( monkey.test.testValue <= 0 || static_cast<uint64_t>( monkey.test.testValue ) > BarrettReducer::maxModulus )
+                    throw std::runtime_error( "invalid test value" );
+
+                auto divisor = ranges::find( divisors, monkey.test.testValue );
+                if( divisor == divisors.end() )
+                    divisor = divisors.insert( divisors.end(), monkey.test.testValue );
+
+                rules.push_back( { monkey.operation.kind, monkey.operation.constant, monkey.test.testValue,
+                    static_cast<int32_t>( monkey.test.trueMonkey ), static_cast<int32_t>( monkey.test.falseMonkey ),
+                    DivisibilityTest( monkey.test.testValue ), std::distance( divisors.begin(), divisor ) } );
+                startItems.push_back( monkey.items );
+                numItems += std::ssize( monkey.items );
+            }
+
+            if( auto lcm = getCombinedModulus( rules, true ) )
+                worryReducer.emplace( *lcm );
+            if( auto product = getCombinedModulus( rules, false ); product && *product <= BarrettReducer::maxModulus / 3 )
+                dividedWorryReducer.emplace( 3 * *product );
+        }
+
+        int64_t getNumMonkeys() const {
+            return std::ssize( rules );
+        }
+
+        int64_t getNumItems() const {
+            return numItems;
+        }
+
+        const MonkeyRule& getRule( int64_t monkey ) const {
+            return rules[ monkey ];
+        }
+
+        const std::vector<int64_t>& getStartItems( int64_t monkey ) const {
+            return startItems[ monkey ];
+        }
+
+        bool hasWorryModulus() const {
+            return worryReducer.has_value();
+        }
+
+        int64_t getNewWorry( const MonkeyRule& rule, int64_t worry, bool divideByThree ) const {
+            const auto newWorry = applyOperation( rule, static_cast<uint64_t>( worry ) );
+            if( divideByThree )
+                return static_cast<int64_t>( dividedWorryReducer->reduce( newWorry ) / 3 );
+            return static_cast<int64_t>( worryReducer->reduce( newWorry ) );
+        }
+
+        void checkWorryModulus( bool divideByThree ) const {
+            if( divideByThree && !dividedWorryReducer )
+                throw std::runtime_error( "test values too large to divide worry levels by three" );
+            if( !divideByThree && !worryReducer )
+                throw std::runtime_error( "test values too large for a common modulus" );
+        }
+
+        std::vector<int64_t> getInspectionCounts( int64_t rounds, bool divideByThree ) const {
+            if( !divideByThree && !worryReducer )
+                return getInspectionCountsPerDivisor( rounds );
+            checkWorryModulus( divideByThree );
+
+            const auto numMonkeys = getNumMonkeys();
+            int64_t capacity = 1;
+            while( capacity < numItems )
+                capacity *= 2;
+            const auto mask = capacity - 1;
+
+            std::vector<int64_t> items( numMonkeys * capacity );
+            std::vector<int64_t> heads( numMonkeys );
+            std::vector<int64_t> sizes( numMonkeys );
+            for( int64_t monkey = 0; monkey < numMonkeys; monkey++ ) {
+                ranges::copy( startItems[ monkey ], items.begin() + monkey * capacity );
+                sizes[ monkey ] = std::ssize( startItems[ monkey ] );
+            }
+
+            std::vector<int64_t> inspectionCounts( numMonkeys );
+            for( int64_t round = 0; round < rounds; round++ ) {
+                for( int64_t monkey = 0; monkey < numMonkeys; monkey++ ) {
+                    const auto& rule = rules[ monkey ];
+                    const auto* monkeyItems = items.data() + monkey * capacity;
+                    // Items thrown to itself are inspected next round, like in throwItems
+                    const auto numThrown = sizes[ monkey ];
+                    const auto head = heads[ monkey ];
+                    inspectionCounts[ monkey ] += numThrown;
+
+                    for( int64_t i = 0; i < numThrown; i++ ) {
+                        const auto item = getNewWorry( rule, monkeyItems[ ( head + i ) & mask ], divideByThree );
+
+                        const auto target = rule.test.isDivisible( item ) ? rule.trueMonkey : rule.falseMonkey;
+                        items[ target * capacity + ( ( heads[ target ] + sizes[ target ] ) & mask ) ] = item;
+                        sizes[ target ]++;
+                    }
+                    heads[ monkey ] = ( head + numThrown ) & mask;
+                    sizes[ monkey ] -= numThrown;
+                }
+            }
+            return inspectionCounts;
+        }
+
+        // Without a common modulus every item carries its residue for each distinct test
+        // value. Items are independent, so they are simulated one after the other.
+        std::vector<int64_t> getInspectionCountsPerDivisor( int64_t rounds ) const {
+            std::vector<BarrettReducer> reducers;
+            for( auto divisor : divisors )
+                reducers.emplace_back( divisor );
+
+            std::vector<int64_t> inspectionCounts( getNumMonkeys() );
+            std::vector<uint64_t> residues( divisors.size() );
+            for( int64_t startMonkey = 0; startMonkey < getNumMonkeys(); startMonkey++ ) {
+                for( auto worry : startItems[ startMonkey ] ) {
+                    for( size_t i = 0; i < divisors.size(); i++ )
+                        residues[ i ] = reducers[ i ].reduce( { 0, static_cast<uint64_t>( worry ) } );
+
+                    auto monkey = startMonkey;
+                    for( int64_t round = 0; round < rounds; round++ ) {
+                        for( ;; ) {
+                            const auto& rule = rules[ monkey ];
+                            inspectionCounts[ monkey ]++;
+                            for( size_t i = 0; i < divisors.size(); i++ )
+                                residues[ i ] = reducers[ i ].reduce( applyOperation( rule, residues[ i ] ) );
+
+                            const int64_t target = residues[ rule.divisorIndex ] == 0 ? rule.trueMonkey : rule.falseMonkey;
+                            const bool isNextRound = target <= monkey;
+                            monkey = target;
+                            if( isNextRound )
+                                break;
+                        }
+                    }
+                }
+            }
+            return inspectionCounts;
+        }
+
+    private:
+        std::vector<MonkeyRule> rules;
+        std::vector<int64_t> divisors;
+        std::vector<std::vector<int64_t>> startItems;
+        int64_t numItems = 0;
+        std::optional<BarrettReducer> worryReducer;
+        std::optional<BarrettReducer> dividedWorryReducer;
+    };
+
+    // Items never interact, so every item can be followed on its own. The state of an item at
+    // the start of a round is its monkey and its reduced worry level, which makes the sequence
+    // of round start states eventually periodic. Brent's cycle detection finds the period, after
+    // that the inspections of any number of rounds follow from one prefix and one period.
+    struct ItemState
+    {
+        int64_t monkey;
+        int64_t worry;
+
+        bool operator==( const ItemState& ) const = default;
+    };
+
+    class ItemTrajectory
+    {
+    public:
+        ItemTrajectory( const MonkeyProgram& program, bool divideByThree )
+            : program( program ), divideByThree( divideByThree ) {
+            program.checkWorryModulus( divideByThree );
+        }
+
+        ItemState advanceRound( ItemState item ) const {
+            return advanceRound<false>( item, nullptr );
+        }
+
+        ItemState advanceRound( ItemState item, std::vector<int64_t>& inspectionCounts ) const {
+            return advanceRound<true>( item, &inspectionCounts );
+        }
+
+        ItemState advanceRounds( ItemState item, int64_t rounds, std::vector<int64_t>& inspectionCounts ) const {
+            for( int64_t round = 0; round < rounds; round++ )
+                item = advanceRound( item, inspectionCounts );
+            return item;
+        }
+
+        void addInspectionCounts( ItemState item, int64_t rounds, std::vector<int64_t>& inspectionCounts ) const {
+            // Find the period, giving up once that costs more than simulating all rounds
+            int64_t power = 1;
+            int64_t period = 1;
+            auto tortoise = item;
+            auto hare = advanceRound( item );
+            for( int64_t steps = 1; tortoise != hare; steps++ ) {
+                if( steps > rounds ) {
+                    advanceRounds( item, rounds, inspectionCounts );
+                    return;
+                }
+                if( power == period ) {
+                    tortoise = hare;
+                    power *= 2;
+                    period = 0;
+                }
+                hare = advanceRound( hare );
+                period++;
+            }
+
+            int64_t prefixLength = 0;
+            tortoise = hare = item;
+            for( int64_t i = 0; i < period; i++ )
+                hare = advanceRound( hare );
+            while( tortoise != hare ) {
+                tortoise = advanceRound( tortoise );
+                hare = advanceRound( hare );
+                prefixLength++;
+            }
+
+            auto cycleStart = advanceRounds( item, std::min( rounds, prefixLength ), inspectionCounts );
+            if( rounds <= prefixLength )
+                return;
+
+            const auto numPeriods = ( rounds - prefixLength ) / period;
+            std::vector<int64_t> periodCounts( inspectionCounts.size() );
+            advanceRounds( cycleStart, period, periodCounts );
+            for( size_t monkey = 0; monkey < inspectionCounts.size(); monkey++ )
+                inspectionCounts[ monkey ] += periodCounts[ monkey ] * numPeriods;
+            advanceRounds( cycleStart, ( rounds - prefixLength ) % period, inspectionCounts );
+        }
+
+    private:
+        template<bool countInspections>
+        ItemState advanceRound( ItemState item, std::vector<int64_t>* inspectionCounts ) const {
+            // The item is inspected again in the same round as long as it moves to a later monkey
+            for( ;; ) {
+                const auto& rule = program.getRule( item.monkey );
+                if constexpr( countInspections )
+                    ( *inspectionCounts )[ item.monkey ]++;
+
+                const auto worry = program.getNewWorry( rule, item.worry, divideByThree );
+                const int64_t target = rule.test.isDivisible( worry ) ? rule.trueMonkey : rule.falseMonkey;
+                const bool isNextRound = target <= item.monkey;
+                item = { target, worry };
+                if( isNextRound )
+                    return item;
+            }
+        }
+
+        const MonkeyProgram& program;
+        bool divideByThree;
+    };
+
+    std::vector<int64_t> getInspectionCountsPerItem( const MonkeyProgram& program, int64_t rounds, bool divideByThree ) {
+        if( !divideByThree && !program.hasWorryModulus() )
+            return program.getInspectionCountsPerDivisor( rounds );
+
+        const ItemTrajectory trajectory( program, divideByThree );
+        std::vector<int64_t> inspectionCounts( program.getNumMonkeys() );
+        for( int64_t monkey = 0; monkey < program.getNumMonkeys(); monkey++ )
+            for( auto worry : program.getStartItems( monkey ) )
+                trajectory.addInspectionCounts( { monkey, worry }, rounds, inspectionCounts );
+        return inspectionCounts;
+    }
+
+    // Items are handed out in small batches since their cost depends on how soon their
+    // trajectory repeats. Every thread counts into its own vector, these are summed at the end.
+    constexpr int64_t itemBatchSize = 16;
+
+    std::vector<int64_t> getInspectionCountsPerItemParallel( const MonkeyProgram& program, int64_t rounds, bool divideByThree,
+        int64_t numThreads = std::thread::hardware_concurrency() ) {
+        if( !divideByThree && !program.hasWorryModulus() )
+            return program.getInspectionCountsPerDivisor( rounds );
+
+        std::vector<ItemState> items;
+        for( int64_t monkey = 0; monkey < program.getNumMonkeys(); monkey++ )
+            for( auto worry : program.getStartItems( monkey ) )
+                items.push_back( { monkey, worry } );
+
+        numThreads = std::clamp<int64_t>( numThreads, 1, std::max<int64_t>( std::ssize( items ) / itemBatchSize, 1 ) );
+        const ItemTrajectory trajectory( program, divideByThree );
+        std::vector<std::vector<int64_t>> threadCounts( numThreads );
+        std::atomic<int64_t> nextItem = 0;
+        auto simulateItems = [&] ( std::vector<int64_t>& threadInspectionCounts ) {
+            std::vector<int64_t> inspectionCounts( program.getNumMonkeys() );
+            for( int64_t batch = nextItem.fetch_add( itemBatchSize ); batch < std::ssize( items ); batch = nextItem.fetch_add( itemBatchSize ) )
+                for( auto& item : std::span( items ).subspan( batch, std::min( itemBatchSize, std::ssize( items ) - batch ) ) )
+                    trajectory.addInspectionCounts( item, rounds, inspectionCounts );
+            threadInspectionCounts = std::move( inspectionCounts );
+        };
+
+        {
+            std::vector<std::jthread> threads;
+            for( int64_t i = 1; i < numThreads; i++ )
+                threads.emplace_back( simulateItems, std::ref( threadCounts[ i ] ) );
+            simulateItems( threadCounts[ 0 ] );
+        }
+
+        std::vector<int64_t> inspectionCounts( program.getNumMonkeys() );
+        for( auto& counts : threadCounts )
+            for( int64_t monkey = 0; monkey < std::ssize( counts ); monkey++ )
+                inspectionCounts[ monkey ] += counts[ monkey ];
+        return inspectionCounts;
+    }
+
+    enum class Engine
+    {
+        RoundByRound,
+        PerItem,
+        PerItemParallel
+    };
+
+    // Counts for huge round numbers fit in 64 bits, their product does not, so it is kept in 128
+    Wide getMonkeyBusiness( std::vector<int64_t> inspectionCounts ) {
+        ranges::nth_element( inspectionCounts, inspectionCounts.begin() + 1, ranges::greater() );
+        const auto first = static_cast<uint64_t>( inspectionCounts[ 0 ] );
+        const auto second = static_cast<uint64_t>( inspectionCounts[ 1 ] );
+        return { multiplyHigh( first, second ), first * second };
+    }
+
+    Wide getTopMonkeysScore( const MonkeyProgram& program, int64_t rounds, bool divideByThree, Engine engine = Engine::RoundByRound ) {
+        if( engine == Engine::PerItem )
+            return getMonkeyBusiness( getInspectionCountsPerItem( program, rounds, divideByThree ) );
+        if( engine == Engine::PerItemParallel )
+            return getMonkeyBusiness( getInspectionCountsPerItemParallel( program, rounds, divideByThree ) );
+        return getMonkeyBusiness( program.getInspectionCounts( rounds, divideByThree ) );
+    }
+
     void execute() {
         std::ifstream file( "input/Day11.txt" );
         const auto monkeys = parseInput( file );
 
-        auto commonDenominator = getCommonDenominator( monkeys );
+        const MonkeyProgram program( monkeys );
 
-        fmt::print( "Day 11: Score of top monkeys: {}\n", getTopMonkeysScore( monkeys, 20, commonDenominator, true ) );
-        fmt::print( "Day 11: Score of top monkeys with much worrying: {}\n", getTopMonkeysScore( monkeys, 10'000, commonDenominator, false ) );
+        fmt::print( "Day 11: Score of top monkeys: {}\n", toString( getTopMonkeysScore( program, 20, true ) ) );
+        fmt::print( "Day 11: Score of top monkeys with much worrying: {}\n", toString( getTopMonkeysScore( program, 10'000, false ) ) );
     }
 }
@@ -13,6 +13,8 @@
 #include <map>
 #include <fmt/core.h>
 #include <regex>
+#include <string_view>
+#include <iterator>
 
 namespace Day4
 {
@@ -69,11 +71,166 @@ namespace Day4
         return ranges::accumulate( sectionPairs | transform( isPartlyOverlap ), 0ll );
     }
 
+    // Structure-of-arrays layout of all pairs, one column per section bound.
+    struct SectionColumns
+    {
+        std::vector<uint32_t> firstMin;
+        std::vector<uint32_t> firstMax;
+        std::vector<uint32_t> secondMin;
+        std::vector<uint32_t> secondMax;
+    };
+
+    struct OverlapCounts
+    {
+        int64_t complete = 0;
+        int64_t partly = 0;
+    };
+
+    uint32_t parseNumber( std::string_view data, size_t& pos ) {
+        uint32_t value = 0;
+        for( ; pos < data.size() && data[ pos ] >= '0' && data[ pos ] <= '9'; pos++ )
+            value = value * 10 + ( data[ pos ] - '0' );
+
+        pos++; // skip separator
+        return value;
+    }
+
+    SectionColumns parseInputColumns( std::istream& stream ) {
+        const std::string data( std::istreambuf_iterator<char>( stream ), {} );
+        const std::string_view view( data );
+
+        SectionColumns columns;
+        const auto expectedPairs = ranges::count( data, '\n' ) + 1;
+        for( auto* column : { &columns.firstMin, &columns.firstMax, &columns.secondMin, &columns.secondMax } )
+            column->reserve( expectedPairs );
+
+        size_t pos = 0;
+        while( pos < view.size() ) {
+            if( view[ pos ] < '0' || view[ pos ] > '9' ) {
+                pos++;
+                continue;
+            }
+            columns.firstMin.push_back( parseNumber( view, pos ) );
+            columns.firstMax.push_back( parseNumber( view, pos ) );
+            columns.secondMin.push_back( parseNumber( view, pos ) );
+            columns.secondMax.push_back( parseNumber( view, pos ) );
+        }
+
+        return columns;
+    }
+
+    // Branch-free kernel: both counts are accumulated with bitwise ops only, so the
+    // compiler can vectorize the loop over the columns with whatever vector width the
+    // build targets.
+    OverlapCounts countOverlaps( const SectionColumns& columns ) {
+        constexpr size_t blockSize = 1 << 16;
+
+        const auto numPairs = columns.firstMin.size();
+        const uint32_t* firstMin = columns.firstMin.data();
+        const uint32_t* firstMax = columns.firstMax.data();
+        const uint32_t* secondMin = columns.secondMin.data();
+        const uint32_t* secondMax = columns.secondMax.data();
+
+        OverlapCounts counts;
+        for( size_t blockStart = 0; blockStart < numPairs; blockStart += blockSize ) {
+            const auto blockEnd = std::min( numPairs, blockStart + blockSize );
+
+            uint32_t complete = 0;
+            uint32_t partly = 0;
+            for( size_t i = blockStart; i < blockEnd; i++ ) {
+                const uint32_t firstContains = ( firstMin[ i ] <= secondMin[ i ] ) & ( firstMax[ i ] >= secondMax[ i ] );
+                const uint32_t secondContains = ( secondMin[ i ] <= firstMin[ i ] ) & ( secondMax[ i ] >= firstMax[ i ] );
+                complete += firstContains | secondContains;
+                partly += ( firstMax[ i ] >= secondMin[ i ] ) & ( firstMin[ i ] <= secondMax[ i ] );
+            }
+
+            counts.complete += complete;
+            counts.partly += partly;
+        }
+
+        return counts;
+    }
+
+    // Index over every assignment in the file (both sections of each pair), answering
+    // coverage queries without comparing all assignments against each other.
+    class SectionIndex
+    {
+        public:
+        explicit SectionIndex( const SectionColumns& columns ) {
+            mins.reserve( 2 * columns.firstMin.size() );
+            maxs.reserve( 2 * columns.firstMax.size() );
+            ranges::copy( columns.firstMin, back_inserter( mins ) );
+            ranges::copy( columns.secondMin, back_inserter( mins ) );
+            ranges::copy( columns.firstMax, back_inserter( maxs ) );
+            ranges::copy( columns.secondMax, back_inserter( maxs ) );
+            ranges::sort( mins );
+            ranges::sort( maxs );
+
+            overlappingCrossPairs = calculateOverlappingPairs() - countOverlaps( columns ).partly;
+            maxCoverage = calculateMaxCoverage();
+        }
+
+        // Number of assignments containing the given section.
+        int64_t getCoverage( int64_t section ) const {
+            if( section < 0 )
+                return 0;
+
+            const auto value = static_cast<uint32_t>( section );
+            const auto started = ranges::upper_bound( mins, value ) - mins.begin();
+            const auto ended = ranges::lower_bound( maxs, value ) - maxs.begin();
+            return started - ended;
+        }
+
+        // Number of overlapping assignment pairs taken from different lines.
+        int64_t getNumOverlappingCrossPairs() const {
+            return overlappingCrossPairs;
+        }
+
+        // Highest number of assignments covering any single section.
+        int64_t getMaxCoverage() const {
+            return maxCoverage;
+        }
+
+        private:
+        int64_t calculateOverlappingPairs() const {
+            // Two assignments are disjoint iff one ends before the other starts, so count
+            // the disjoint pairs per end and subtract from all pairs.
+            const int64_t numAssignments = std::ssize( mins );
+            int64_t disjointPairs = 0;
+            auto firstLaterStart = mins.begin();
+            for( auto max : maxs ) {
+                firstLaterStart = std::upper_bound( firstLaterStart, mins.end(), max );
+                disjointPairs += mins.end() - firstLaterStart;
+            }
+
+            return numAssignments * ( numAssignments - 1 ) / 2 - disjointPairs;
+        }
+
+        int64_t calculateMaxCoverage() const {
+            int64_t coverage = 0;
+            int64_t maxValue = 0;
+            auto end = maxs.begin();
+            for( auto min : mins ) {
+                for( ; end != maxs.end() && *end < min; ++end )
+                    coverage--;
+                maxValue = std::max( maxValue, ++coverage );
+            }
+
+            return maxValue;
+        }
+
+        std::vector<uint32_t> mins;
+        std::vector<uint32_t> maxs;
+        int64_t overlappingCrossPairs = 0;
+        int64_t maxCoverage = 0;
+    };
+
     void execute() {
         std::ifstream file( "input/Day4.txt" );
-        auto data = parseInput( file );
+        const auto columns = parseInputColumns( file );
+        const auto counts = countOverlaps( columns );
 
-        fmt::print( "Day4: Number of complete overlaps: {}\n", getNumberOfCompleteOverlapping( data ) );
-        fmt::print( "Day4: Number of partly overlaps: {}\n", getNumberOfPartlyOverlapping( data ) );
+        fmt::print( "Day4: Number of complete overlaps: {}\n", counts.complete );
+        fmt::print( "Day4: Number of partly overlaps: {}\n", counts.partly );
     }
 }
\ No newline at end of file
@@ -14,6 +14,8 @@
 #include <fmt/core.h>
 #include <regex>
 #include <deque>
+#include <iterator>
+#include <stdexcept>
 
 namespace Day5
 {
@@ -125,11 +127,275 @@ namespace Day5
         return getTopCargo( workCargo );
     }
 
+    enum class Crane
+    {
+        CrateMover9000, // moves crates one by one, reversing their order
+        CrateMover9001  // moves crates as one block, keeping their order
+    };
+
+    // Stack stored in a single contiguous buffer, a move is one block copy.
+    class BufferStack
+    {
+        public:
+        void push( char crate ) {
+            crates.push_back( crate );
+        }
+        char top() const {
+            return crates.back();
+        }
+        char getFromTop( int64_t depth ) const {
+            return *( crates.rbegin() + depth );
+        }
+        int64_t size() const {
+            return std::ssize( crates );
+        }
+        void moveTo( BufferStack& target, int64_t count, Crane crane ) {
+            const auto blockStart = crates.end() - count;
+            if( crane == Crane::CrateMover9001 )
+                target.crates.insert( target.crates.end(), blockStart, crates.end() );
+            else
+                target.crates.insert( target.crates.end(), crates.rbegin(), crates.rbegin() + count );
+
+            crates.erase( blockStart, crates.end() );
+        }
+
+        private:
+        std::vector<char> crates;
+    };
+
+    // Stack stored as a rope of bounded chunks. Full chunks are handed over to the
+    // target without copying, so huge block moves only copy the partial chunks at the ends.
+    class ChunkedStack
+    {
+        public:
+        static constexpr int64_t chunkSize = 4096;
+
+        void push( char crate ) {
+            append( &crate, &crate + 1 );
+        }
+        char top() const {
+            return chunks.back().back();
+        }
+        int64_t size() const {
+            return ranges::accumulate( chunks, 0ll, ranges::plus(), [] ( auto& chunk ) { return std::ssize( chunk ); } );
+        }
+        void moveTo( ChunkedStack& target, int64_t count, Crane crane ) {
+            if( crane == Crane::CrateMover9000 ) {
+                while( count > 0 ) {
+                    auto& chunk = chunks.back();
+                    const auto taken = std::min( count, std::ssize( chunk ) );
+                    target.appendReversed( chunk.data() + chunk.size() - taken, chunk.data() + chunk.size() );
+                    popBack( chunk, taken );
+                    count -= taken;
+                }
+                return;
+            }
+
+            auto firstMovedChunk = chunks.end();
+            int64_t remaining = count;
+            while( remaining > 0 && remaining >= std::ssize( *std::prev( firstMovedChunk ) ) )
+                remaining -= std::ssize( *--firstMovedChunk );
+
+            if( remaining > 0 ) {
+                auto& partialChunk = *std::prev( firstMovedChunk );
+                target.append( partialChunk.data() + partialChunk.size() - remaining, partialChunk.data() + partialChunk.size() );
+                partialChunk.resize( partialChunk.size() - remaining );
+            }
+
+            std::move( firstMovedChunk, chunks.end(), back_inserter( target.chunks ) );
+            chunks.erase( firstMovedChunk, chunks.end() );
+        }
+
+        private:
+        void append( const char* first, const char* last ) {
+            while( first != last ) {
+                if( chunks.empty() || std::ssize( chunks.back() ) == chunkSize )
+                    chunks.emplace_back().reserve( chunkSize );
+
+                auto& chunk = chunks.back();
+                const auto copied = std::min<int64_t>( last - first, chunkSize - std::ssize( chunk ) );
+                chunk.insert( chunk.end(), first, first + copied );
+                first += copied;
+            }
+        }
+        void appendReversed( const char* first, const char* last ) {
+            while( first != last ) {
+                if( chunks.empty() || std::ssize( chunks.back() ) == chunkSize )
+                    chunks.emplace_back().reserve( chunkSize );
+
+                auto& chunk = chunks.back();
+                const auto copied = std::min<int64_t>( last - first, chunkSize - std::ssize( chunk ) );
+                chunk.insert( chunk.end(), std::make_reverse_iterator( last ), std::make_reverse_iterator( last - copied ) );
+                last -= copied;
+            }
+        }
+        void popBack( std::vector<char>& chunk, int64_t count ) {
+            chunk.resize( chunk.size() - count );
+            if( chunk.empty() )
+                chunks.pop_back();
+        }
+
+        std::vector<std::vector<char>> chunks;
+    };
+
+    template<typename Stack>
+    std::vector<Stack> toStacks( const CargoStacks& cargo ) {
+        std::vector<Stack> stacks( cargo.size() );
+        for( int64_t i = 0; i < std::ssize( cargo ); i++ )
+            for( auto crate : cargo[ i ] )
+                stacks[ i ].push( crate );
+
+        return stacks;
+    }
+
+    template<typename Stack>
+    std::string getTopCargoBulk( const CargoSetup& cargoSetup, Crane crane ) {
+        auto stacks = toStacks<Stack>( cargoSetup.cargo );
+
+        for( auto& move : cargoSetup.moves )
+            stacks[ move.from ].moveTo( stacks[ move.to ], move.count, crane );
+
+        std::string topCargo;
+        for( auto& stack : stacks )
+            topCargo += stack.top();
+
+        return topCargo;
+    }
+
+    // Position of a crate, depth 0 is the top of the stack.
+    struct CratePosition
+    {
+        int64_t stack = 0;
+        int64_t depth = 0;
+    };
+
+    void undoMove( CratePosition& position, const Move& move, Crane crane ) {
+        if( position.stack == move.to ) {
+            if( position.depth >= move.count ) {
+                position.depth -= move.count;
+                return;
+            }
+
+            position.stack = move.from;
+            if( crane == Crane::CrateMover9000 )
+                position.depth = move.count - 1 - position.depth;
+        }
+        else if( position.stack == move.from ) {
+            position.depth += move.count;
+        }
+    }
+
+    // Walks the moves backwards, tracking only where each final top crate came from,
+    // then reads the crates from the stacks as they were before the first move.
+    template<typename GetCrate>
+    std::string resolveTopCargo( std::vector<CratePosition> positions, std::span<const Move> moves, Crane crane, GetCrate getCrate ) {
+        for( auto& move : moves | ranges::views::reverse )
+            for( auto& position : positions )
+                undoMove( position, move, crane );
+
+        std::string topCargo;
+        for( auto& [stack, depth] : positions )
+            topCargo += getCrate( stack, depth );
+
+        return topCargo;
+    }
+
+    // Cost does not depend on the number of crates moved, only on moves x stacks.
+    std::string getTopCargoBackward( const CargoSetup& cargoSetup, Crane crane ) {
+        std::vector<CratePosition> positions;
+        for( int64_t i = 0; i < std::ssize( cargoSetup.cargo ); i++ )
+            positions.push_back( { i, 0 } );
+
+        return resolveTopCargo( std::move( positions ), cargoSetup.moves, crane, [&] ( int64_t stack, int64_t depth ) {
+            return *( cargoSetup.cargo[ stack ].rbegin() + depth );
+        } );
+    }
+
+    enum class Solver
+    {
+        ForwardSimulation,
+        BackwardTracking
+    };
+
+    std::string getTopCargo( const CargoSetup& cargoSetup, Crane crane, Solver solver ) {
+        if( solver == Solver::BackwardTracking )
+            return getTopCargoBackward( cargoSetup, crane );
+
+        return getTopCargoBulk<BufferStack>( cargoSetup, crane );
+    }
+
+    // Stack state over the move list, stored as a checkpoint every checkpointInterval moves.
+    // Queries start from the closest checkpoint before the requested move, so the interval
+    // trades memory (total crates per checkpoint) against query latency (moves replayed).
+    class CargoHistory
+    {
+        public:
+        CargoHistory( const CargoSetup& cargoSetup, Crane crane, int64_t checkpointInterval )
+            : moves( cargoSetup.moves ), crane( crane ), checkpointInterval( checkpointInterval ) {
+            if( checkpointInterval <= 0 )
+                throw std::runtime_error( "checkpoint interval must be positive" );
+
+            auto stacks = toStacks<BufferStack>( cargoSetup.cargo );
+            for( int64_t i = 0; i < std::ssize( moves ); i++ ) {
+                if( i % checkpointInterval == 0 )
+                    checkpoints.push_back( stacks );
+
+                auto& move = moves[ i ];
+                stacks[ move.from ].moveTo( stacks[ move.to ], move.count, crane );
+            }
+            if( std::ssize( moves ) % checkpointInterval == 0 )
+                checkpoints.push_back( std::move( stacks ) );
+        }
+
+        // Top crates after the first moveCount moves have been executed, empty stacks are skipped.
+        std::string getTopCargoAfter( int64_t moveCount ) const {
+            const auto& checkpoint = checkpoints[ moveCount / checkpointInterval ];
+            const auto heights = getStackHeightsAfter( moveCount );
+
+            std::vector<CratePosition> positions;
+            for( int64_t i = 0; i < std::ssize( heights ); i++ )
+                if( heights[ i ] > 0 )
+                    positions.push_back( { i, 0 } );
+
+            return resolveTopCargo( std::move( positions ), getReplayedMoves( moveCount ), crane, [&] ( int64_t stack, int64_t depth ) {
+                return checkpoint[ stack ].getFromTop( depth );
+            } );
+        }
+
+        // Height of the given stack after the first moveCount moves have been executed.
+        int64_t getStackHeightAfter( int64_t stack, int64_t moveCount ) const {
+            return getStackHeightsAfter( moveCount )[ stack ];
+        }
+
+        private:
+        std::span<const Move> getReplayedMoves( int64_t moveCount ) const {
+            return std::span( moves ).subspan( moveCount - moveCount % checkpointInterval, moveCount % checkpointInterval );
+        }
+
+        std::vector<int64_t> getStackHeightsAfter( int64_t moveCount ) const {
+            std::vector<int64_t> heights;
+            for( auto& stack : checkpoints[ moveCount / checkpointInterval ] )
+                heights.push_back( stack.size() );
+
+            for( auto& move : getReplayedMoves( moveCount ) ) {
+                heights[ move.from ] -= move.count;
+                heights[ move.to ] += move.count;
+            }
+
+            return heights;
+        }
+
+        std::vector<Move> moves;
+        Crane crane;
+        int64_t checkpointInterval = 1;
+        std::vector<std::vector<BufferStack>> checkpoints;
+    };
+
     void execute() {
         std::ifstream file( "input/Day5.txt" );
         auto cargoSetup = parseInput( file );
 
-        fmt::print( "Day5: Top cargo items: {}\n", getTopCargo( cargoSetup ) );
-        fmt::print( "Day5: Top cargo items advanced: {}\n", getTopCargoAdvanced( cargoSetup ) );
+        fmt::print( "Day5: Top cargo items: {}\n", getTopCargo( cargoSetup, Crane::CrateMover9000, Solver::BackwardTracking ) );
+        fmt::print( "Day5: Top cargo items advanced: {}\n", getTopCargo( cargoSetup, Crane::CrateMover9001, Solver::BackwardTracking ) );
     }
 }
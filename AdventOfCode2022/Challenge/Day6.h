@@ -7,7 +7,26 @@
 #include <algorithm>
 #include <range/v3/all.hpp>
 #include <fmt/core.h>
-#include <unordered_set>
+#include <array>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <atomic>
+#include <limits>
+#include <filesystem>
+#include <stdexcept>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace Day6
 {
@@ -17,24 +36,247 @@ namespace Day6
         return data;
     }
 
-    bool hasOnlyUniqueElements( auto& data ) {
-        std::unordered_set<char> set( begin( data ), end( data ) );
+    // Sliding window over the signal that keeps a count per byte value and the number of
+    // values occurring more than once, so each step is O(1) for any marker size.
+    class MarkerWindow
+    {
+        public:
+        explicit MarkerWindow( int64_t markerSize ) : markerSize( markerSize ) {}
 
-        return set.size() == data.size();
+        // Adds the byte at position pos, returns true if the window ending there is a marker.
+        bool push( std::string_view data, int64_t pos ) {
+            if( ++counts[ static_cast<uint8_t>( data[ pos ] ) ] == 2 )
+                duplicates++;
+
+            if( pos >= markerSize && --counts[ static_cast<uint8_t>( data[ pos - markerSize ] ) ] == 1 )
+                duplicates--;
+
+            return pos + 1 >= markerSize && duplicates == 0;
+        }
+
+        private:
+        int64_t markerSize = 0;
+        int64_t duplicates = 0;
+        std::array<int32_t, 256> counts = {};
+    };
+
+    // Finds the markers for all sizes in a single pass, -1 if a marker does not exist.
+    std::vector<int64_t> getStartPacketMarkers( std::string_view data, std::span<const int64_t> markerSizes ) {
+        std::vector<int64_t> markers( markerSizes.size(), -1 );
+        std::vector<std::pair<int64_t, MarkerWindow>> windows;
+        for( int64_t i = 0; i < std::ssize( markerSizes ); i++ )
+            if( markerSizes[ i ] > 0 && markerSizes[ i ] <= 256 )
+                windows.emplace_back( i, MarkerWindow( markerSizes[ i ] ) );
+
+        for( int64_t pos = 0; pos < std::ssize( data ) && !windows.empty(); pos++ ) {
+            std::erase_if( windows, [&] ( auto& entry ) {
+                auto& [index, window] = entry;
+                if( !window.push( data, pos ) )
+                    return false;
+
+                markers[ index ] = pos + 1;
+                return true;
+            } );
+        }
+
+        return markers;
     }
 
-    int64_t getStartPacketMarker( const std::string& data, int64_t markerSize ) {
-        auto view = data | ranges::views::sliding(markerSize);
-        auto it = ranges::find_if( view, [](const auto& v) { return hasOnlyUniqueElements(v); } );
+    struct SkipAheadResult
+    {
+        int64_t marker = -1;
+        int64_t inspectedBytes = 0;
+    };
+
+    // Checks each window from its end backwards. A byte seen twice means no window starting
+    // at or before its earlier occurrence can be a marker, so the search jumps past it.
+    SkipAheadResult searchSkipAhead( std::string_view data, int64_t markerSize ) {
+        SkipAheadResult result;
+        if( markerSize <= 0 || markerSize > 256 )
+            return result;
+
+        std::array<int64_t, 256> seenInWindow;
+        seenInWindow.fill( -1 );
+
+        for( int64_t start = 0; start + markerSize <= std::ssize( data ); ) {
+            int64_t pos = start + markerSize - 1;
+            for( ; pos >= start; pos-- ) {
+                result.inspectedBytes++;
+                auto& seen = seenInWindow[ static_cast<uint8_t>( data[ pos ] ) ];
+                if( seen == start )
+                    break;
+                seen = start;
+            }
+
+            if( pos < start ) {
+                result.marker = start + markerSize;
+                return result;
+            }
+            start = pos + 1;
+        }
+
+        return result;
+    }
+
+    int64_t getStartPacketMarkerSkipAhead( std::string_view data, int64_t markerSize ) {
+        return searchSkipAhead( data, markerSize ).marker;
+    }
+
+    int64_t getStartPacketMarkerIncremental( std::string_view data, int64_t markerSize ) {
+        return getStartPacketMarkers( data, std::array{ markerSize } ).front();
+    }
+
+    enum class MarkerStrategy
+    {
+        Incremental,
+        SkipAhead
+    };
+
+    constexpr int64_t markerSampleSize = 4096;
+
+    // Decides from a skip-ahead search of the sample prefix. It only pays off if it inspects
+    // fewer bytes than the incremental window, which touches every byte once.
+    MarkerStrategy chooseMarkerStrategy( const SkipAheadResult& sampleResult, int64_t sampleSize ) {
+        if( sampleResult.inspectedBytes < sampleSize )
+            return MarkerStrategy::SkipAhead;
+
+        return MarkerStrategy::Incremental;
+    }
+
+    // A marker found in the sample is the first one of the whole signal. Otherwise the chosen
+    // search continues with the first window not completely inside the sample.
+    int64_t getStartPacketMarker( std::string_view data, int64_t markerSize ) {
+        const auto sample = data.substr( 0, markerSampleSize );
+        const auto sampleResult = searchSkipAhead( sample, markerSize );
+        if( sampleResult.marker != -1 || sample.size() == data.size() || markerSize <= 0 || markerSize > 256 )
+            return sampleResult.marker;
+
+        // The sample is longer than any valid marker, so the offset is positive
+        const auto offset = std::ssize( sample ) - markerSize + 1;
+        const auto rest = data.substr( offset );
+        const auto marker = chooseMarkerStrategy( sampleResult, std::ssize( sample ) ) == MarkerStrategy::SkipAhead
+            ? getStartPacketMarkerSkipAhead( rest, markerSize )
+            : getStartPacketMarkerIncremental( rest, markerSize );
+
+        return marker == -1 ? -1 : offset + marker;
+    }
+
+    // Splits the signal into chunks of window starts that overlap by markerSize - 1 bytes.
+    // Threads take chunks in order and publish hits through an atomic minimum, chunks that
+    // start after the best hit so far are skipped. The data can be a view of a mapped file.
+    int64_t getStartPacketMarkerParallel( std::string_view data, int64_t markerSize, int64_t numThreads = std::thread::hardware_concurrency() ) {
+        constexpr int64_t chunkSize = 1 << 20;
+
+        if( markerSize <= 0 || markerSize > 256 || markerSize > std::ssize( data ) )
+            return -1;
+
+        const int64_t numWindows = std::ssize( data ) - markerSize + 1;
+        const int64_t numChunks = ( numWindows + chunkSize - 1 ) / chunkSize;
+        constexpr int64_t notFound = std::numeric_limits<int64_t>::max();
+
+        std::atomic<int64_t> nextChunk = 0;
+        std::atomic<int64_t> firstMarker = notFound;
+
+        auto searchChunks = [&] () {
+            for( int64_t chunk = nextChunk++; chunk < numChunks; chunk = nextChunk++ ) {
+                const auto chunkStart = chunk * chunkSize;
+                if( chunkStart + markerSize >= firstMarker.load( std::memory_order_relaxed ) )
+                    return;
+
+                const auto chunkData = data.substr( chunkStart, chunkSize + markerSize - 1 );
+                const auto marker = getStartPacketMarker( chunkData, markerSize );
+                if( marker == -1 )
+                    continue;
+
+                auto best = firstMarker.load();
+                while( chunkStart + marker < best && !firstMarker.compare_exchange_weak( best, chunkStart + marker ) );
+            }
+        };
+
+        std::vector<std::jthread> threads;
+        for( int64_t i = 1; i < std::clamp<int64_t>( numThreads, 1, numChunks ); i++ )
+            threads.emplace_back( searchChunks );
+        searchChunks();
+        threads.clear();
+
+        return firstMarker == notFound ? -1 : firstMarker.load();
+    }
+
+    // Read-only mapping of a whole file, so signals larger than memory are searched in place.
+    class MappedFile
+    {
+    public:
+        explicit MappedFile( const std::filesystem::path& path ) {
+            size = static_cast<int64_t>( std::filesystem::file_size( path ) );
+            if( size == 0 )
+                return;
+#ifdef _WIN32
+            file = CreateFileW( path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr );
+            if( file == INVALID_HANDLE_VALUE )
+                throw std::runtime_error( "cannot open file" );
+            mapping = CreateFileMappingW( file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+            if( mapping == nullptr ) {
+                CloseHandle( file );
+                throw std::runtime_error( "cannot map file" );
+            }
+            data = static_cast<const char*>( MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 ) );
+            if( data == nullptr ) {
+                CloseHandle( mapping );
+                CloseHandle( file );
+                throw std::runtime_error( "cannot map file" );
+            }
+#else
+            const int file = open( path.c_str(), O_RDONLY );
+            if( file == -1 )
+                throw std::runtime_error( "cannot open file" );
+            void* mapped = mmap( nullptr, size, PROT_READ, MAP_PRIVATE, file, 0 );
+            close( file );
+            if( mapped == MAP_FAILED )
+                throw std::runtime_error( "cannot map file" );
+            madvise( mapped, size, MADV_SEQUENTIAL );
+            data = static_cast<const char*>( mapped );
+#endif
+        }
+
+        MappedFile( const MappedFile& ) = delete;
+        MappedFile& operator=( const MappedFile& ) = delete;
+
+        ~MappedFile() {
+            if( data == nullptr )
+                return;
+#ifdef _WIN32
+            UnmapViewOfFile( data );
+            CloseHandle( mapping );
+            CloseHandle( file );
+#else
+            munmap( const_cast<char*>( data ), size );
+#endif
+        }
+
+        std::string_view getData() const {
+            return { data, static_cast<size_t>( size ) };
+        }
+
+    private:
+#ifdef _WIN32
+        HANDLE file = INVALID_HANDLE_VALUE;
+        HANDLE mapping = nullptr;
+#endif
+        const char* data = nullptr;
+        int64_t size = 0;
+    };
 
-        return it == view.end() ? -1 : it - view.begin() + markerSize;
+    int64_t getStartPacketMarkerOfFile( const std::filesystem::path& path, int64_t markerSize, int64_t numThreads = std::thread::hardware_concurrency() ) {
+        const MappedFile file( path );
+        return getStartPacketMarkerParallel( file.getData(), markerSize, numThreads );
     }
 
     void execute() {
         std::ifstream file( "input/Day6.txt" );
         auto data = parseInput( file );
 
-        fmt::print( "Day6: Start of packet with marker size  4: {}\n", getStartPacketMarker( data, 4 ) );
-        fmt::print( "Day6: Start of packet with marker size 14: {}\n", getStartPacketMarker( data, 14 ) );
+        const auto markers = getStartPacketMarkers( data, std::array<int64_t, 2>{ 4, 14 } );
+        fmt::print( "Day6: Start of packet with marker size  4: {}\n", markers[ 0 ] );
+        fmt::print( "Day6: Start of packet with marker size 14: {}\n", markers[ 1 ] );
     }
 }
\ No newline at end of file
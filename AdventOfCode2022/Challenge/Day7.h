@@ -10,6 +10,17 @@
 #include <variant>
 #include <optional>
 #include <ranges>
+#include <map>
+#include <memory>
+#include <array>
+#include <charconv>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <stdexcept>
 
 namespace Day7
 {
@@ -174,16 +185,647 @@ namespace Day7
         return  std::min( *directorySize, minVal );
     }
 
+    // Interns names into fixed-size blocks, so the views handed out stay valid.
+    class NameTable
+    {
+        public:
+        static constexpr int64_t blockSize = 1 << 16;
+
+        int64_t intern( std::string_view name ) {
+            if( auto it = ids.find( name ); it != ids.end() )
+                return it->second;
+
+            if( blocks.empty() || blockUsed + std::ssize( name ) > blockSize ) {
+                blocks.push_back( std::make_unique<char[]>( std::max<int64_t>( blockSize, std::ssize( name ) ) ) );
+                blockUsed = 0;
+            }
+
+            char* storage = blocks.back().get() + blockUsed;
+            ranges::copy( name, storage );
+            blockUsed += std::ssize( name );
+
+            const std::string_view storedName( storage, name.size() );
+            names.push_back( storedName );
+            return ids.emplace( storedName, std::ssize( names ) - 1 ).first->second;
+        }
+
+        std::string_view getName( int64_t id ) const {
+            return names[ id ];
+        }
+
+        int64_t getNumNames() const {
+            return std::ssize( names );
+        }
+
+        private:
+        std::vector<std::unique_ptr<char[]>> blocks;
+        int64_t blockUsed = 0;
+        std::vector<std::string_view> names;
+        std::unordered_map<std::string_view, int64_t> ids;
+    };
+
+    struct FlatFile
+    {
+        int64_t name = 0;
+        int64_t size = 0;
+    };
+
+    // A parent always precedes its children. Children and files of a directory are created by
+    // the same ls and are therefore contiguous, directories entered by cd before their parent
+    // was listed are regrouped when the tree is built.
+    struct FlatDirectory
+    {
+        int64_t name = 0;
+        int64_t parent = -1;
+        int64_t firstChild = 0;
+        int64_t numChildren = 0;
+        int64_t firstFile = 0;
+        int64_t numFiles = 0;
+        bool isListed = false;
+        int64_t size = 0;
+        int64_t subtreeDirectories = 1; // directories in its subtree, itself included
+    };
+
+    struct FlatTree
+    {
+        NameTable names;
+        std::vector<FlatDirectory> directories;
+        std::vector<FlatFile> files;
+    };
+
+    // Key of a named entry inside a directory, used for hashed lookups.
+    uint64_t getEntryKey( int64_t directory, int64_t name ) {
+        return static_cast<uint64_t>( directory ) << 32 | static_cast<uint64_t>( name );
+    }
+
+    class FlatTreeBuilder
+    {
+        public:
+        FlatTreeBuilder() {
+            tree.directories.push_back( { tree.names.intern( "/" ) } );
+        }
+
+        void changeDirectory( std::string_view path ) {
+            if( path == "/" )
+                currentDirectory = 0;
+            else if( path == ".." )
+                currentDirectory = tree.directories[ currentDirectory ].parent;
+            else
+                currentDirectory = getSubDirectory( currentDirectory, path );
+        }
+
+        void listDirectory() {
+            auto& directory = tree.directories[ currentDirectory ];
+            isSkippingListing = directory.isListed;
+            if( isSkippingListing )
+                return;
+
+            directory.isListed = true;
+            directory.firstChild = std::ssize( tree.directories );
+            directory.firstFile = std::ssize( tree.files );
+        }
+
+        void addListedDirectory( std::string_view name ) {
+            if( isSkippingListing )
+                return;
+
+            const auto nameId = tree.names.intern( name );
+            if( !subDirectories.emplace( getEntryKey( currentDirectory, nameId ), std::ssize( tree.directories ) ).second )
+                return;
+
+            tree.directories[ currentDirectory ].numChildren++;
+            tree.directories.push_back( { nameId, currentDirectory } );
+        }
+
+        void addListedFile( std::string_view name, int64_t size ) {
+            if( isSkippingListing )
+                return;
+
+            tree.directories[ currentDirectory ].numFiles++;
+            tree.files.push_back( { tree.names.intern( name ), size } );
+        }
+
+        FlatTree build() {
+            if( hasUnlistedDirectories )
+                groupChildren();
+
+            for( auto& directory : tree.directories | ranges::views::drop( 1 ) | ranges::views::reverse )
+                tree.directories[ directory.parent ].subtreeDirectories += directory.subtreeDirectories;
+            return std::move( tree );
+        }
+
+        private:
+        // Like the reference tree, cd into a directory that was not listed creates it.
+        int64_t getSubDirectory( int64_t parent, std::string_view name ) {
+            const auto nameId = tree.names.intern( name );
+            const auto [subDirectory, isNew] = subDirectories.emplace( getEntryKey( parent, nameId ), std::ssize( tree.directories ) );
+            if( isNew ) {
+                hasUnlistedDirectories = true;
+                tree.directories.push_back( { nameId, parent } );
+            }
+
+            return subDirectory->second;
+        }
+
+        // Directories created by cd are not next to their listed siblings, so all directories
+        // are renumbered breadth first, which keeps children contiguous and after their parent.
+        void groupChildren() {
+            const auto numDirectories = std::ssize( tree.directories );
+            std::vector<std::vector<int64_t>> children( numDirectories );
+            for( int64_t directory = 1; directory < numDirectories; directory++ )
+                children[ tree.directories[ directory ].parent ].push_back( directory );
+
+            std::vector<int64_t> order = { 0 };
+            std::vector<int64_t> newIndex( numDirectories );
+            std::vector<FlatDirectory> directories;
+            directories.reserve( numDirectories );
+            for( int64_t i = 0; i < numDirectories; i++ ) {
+                auto directory = tree.directories[ order[ i ] ];
+                newIndex[ order[ i ] ] = i;
+                if( i > 0 )
+                    directory.parent = newIndex[ directory.parent ];
+                directory.firstChild = std::ssize( order );
+                directory.numChildren = std::ssize( children[ order[ i ] ] );
+                ranges::copy( children[ order[ i ] ], std::back_inserter( order ) );
+                directories.push_back( directory );
+            }
+            tree.directories = std::move( directories );
+        }
+
+        FlatTree tree;
+        int64_t currentDirectory = 0;
+        bool isSkippingListing = false;
+        bool hasUnlistedDirectories = false;
+        std::unordered_map<uint64_t, int64_t> subDirectories;
+    };
+
+    FlatTree buildFlatTree( const std::vector<Command>& commands ) {
+        FlatTreeBuilder builder;
+        for( auto& command : commands ) {
+            if( auto changeDirectory = std::get_if<ChangeDirectory>( &command ) ) {
+                builder.changeDirectory( changeDirectory->path );
+                continue;
+            }
+
+            builder.listDirectory();
+            for( auto& entry : std::get<ListDirectory>( command ).results ) {
+                if( auto fileInfo = std::get_if<FileInfo>( &entry ) )
+                    builder.addListedFile( fileInfo->name, fileInfo->size );
+                else
+                    builder.addListedDirectory( std::get<DirectoryInfo>( entry ).name );
+            }
+        }
+
+        return builder.build();
+    }
+
+    // Applies the transcript to the tree line by line, without building the command list.
+    FlatTree parseTree( std::istream& stream ) {
+        FlatTreeBuilder builder;
+        for( std::string line; std::getline( stream, line ); ) {
+            const std::string_view view( line );
+            if( view.starts_with( "$ cd " ) )
+                builder.changeDirectory( view.substr( 5 ) );
+            else if( view.starts_with( "$ ls" ) )
+                builder.listDirectory();
+            else if( view.starts_with( "dir " ) )
+                builder.addListedDirectory( view.substr( 4 ) );
+            else {
+                const auto separator = view.find( ' ' );
+                int64_t size = 0;
+                std::from_chars( view.data(), view.data() + separator, size );
+                builder.addListedFile( view.substr( separator + 1 ), size );
+            }
+        }
+
+        return builder.build();
+    }
+
+    // Children always come after their parent, so one reverse pass accumulates all sizes.
+    void calculateDirectorySizes( FlatTree& tree ) {
+        for( auto& directory : tree.directories ) {
+            const auto files = std::span( tree.files ).subspan( directory.firstFile, directory.numFiles );
+            directory.size = ranges::accumulate( files, 0ll, ranges::plus(), &FlatFile::size );
+        }
+
+        for( auto& directory : tree.directories | ranges::views::drop( 1 ) | ranges::views::reverse )
+            tree.directories[ directory.parent ].size += directory.size;
+    }
+
+    int64_t calculateSumOfDirectories( const FlatTree& tree, int64_t maxSize ) {
+        int64_t sum = 0;
+        for( auto& directory : tree.directories )
+            if( directory.size <= maxSize )
+                sum += directory.size;
+
+        return sum;
+    }
+
+    std::optional<int64_t> getSizeOfDeletedDirectory( const FlatTree& tree, int64_t sizeNeeded ) {
+        std::optional<int64_t> minSize;
+        for( auto& directory : tree.directories )
+            if( directory.size >= sizeNeeded && ( !minSize || directory.size < *minSize ) )
+                minSize = directory.size;
+
+        return minSize;
+    }
+
+    // Ordered multiset of sizes as a binary trie over the value bits, each node keeps the
+    // count and sum of the values below it. All operations are O(number of bits).
+    class SizeMultiset
+    {
+        public:
+        static constexpr int64_t numBits = 62;
+        static constexpr int64_t maxValue = ( 1ll << numBits ) - 1;
+
+        SizeMultiset() : nodes( 1 ) {}
+
+        void insert( int64_t value ) {
+            update( value, 1 );
+        }
+
+        void erase( int64_t value ) {
+            update( value, -1 );
+        }
+
+        // Sum of all values <= maxValue.
+        int64_t getSumAtMost( int64_t maxSum ) const {
+            if( maxSum < 0 )
+                return 0;
+            maxSum = std::min( maxSum, maxValue );
+
+            int64_t sum = 0;
+            int64_t node = 0;
+            for( int64_t bit = numBits - 1; bit >= 0 && node != -1; bit-- ) {
+                if( maxSum >> bit & 1 ) {
+                    if( auto lower = nodes[ node ].children[ 0 ]; lower != -1 )
+                        sum += nodes[ lower ].sum;
+                    node = nodes[ node ].children[ 1 ];
+                }
+                else {
+                    node = nodes[ node ].children[ 0 ];
+                }
+            }
+            if( node != -1 )
+                sum += nodes[ node ].sum;
+
+            return sum;
+        }
+
+        // Smallest value >= minValue.
+        std::optional<int64_t> getSmallestAtLeast( int64_t minValue ) const {
+            if( minValue > maxValue )
+                return std::nullopt;
+            minValue = std::max<int64_t>( minValue, 0 );
+
+            // Walk down along minValue, remembering the last point where a larger subtree exists.
+            int64_t node = 0;
+            int64_t branchNode = -1;
+            int64_t branchBit = 0;
+            int64_t branchPrefix = 0;
+            int64_t bit = numBits - 1;
+            for( ; bit >= 0; bit-- ) {
+                const auto direction = minValue >> bit & 1;
+                if( !direction && hasValues( nodes[ node ].children[ 1 ] ) ) {
+                    branchNode = nodes[ node ].children[ 1 ];
+                    branchBit = bit;
+                    branchPrefix = ( minValue >> bit | 1 ) << bit;
+                }
+
+                node = nodes[ node ].children[ direction ];
+                if( !hasValues( node ) )
+                    break;
+            }
+            if( bit < 0 )
+                return minValue;
+            if( branchNode == -1 )
+                return std::nullopt;
+
+            // Smallest value in the remembered subtree.
+            int64_t value = branchPrefix;
+            node = branchNode;
+            for( bit = branchBit - 1; bit >= 0; bit-- ) {
+                if( hasValues( nodes[ node ].children[ 0 ] ) ) {
+                    node = nodes[ node ].children[ 0 ];
+                }
+                else {
+                    node = nodes[ node ].children[ 1 ];
+                    value |= 1ll << bit;
+                }
+            }
+
+            return value;
+        }
+
+        private:
+        struct Node
+        {
+            std::array<int64_t, 2> children = { -1, -1 };
+            int64_t count = 0;
+            int64_t sum = 0;
+        };
+
+        bool hasValues( int64_t node ) const {
+            return node != -1 && nodes[ node ].count > 0;
+        }
+
+        int64_t allocateNode() {
+            if( freeNodes.empty() ) {
+                nodes.emplace_back();
+                return std::ssize( nodes ) - 1;
+            }
+
+            const auto node = freeNodes.back();
+            freeNodes.pop_back();
+            nodes[ node ] = Node();
+            return node;
+        }
+
+        // Nodes whose count drops to zero only hold copies of the erased value, so they form a
+        // single path that is cut off and recycled. The trie never holds more than numBits
+        // nodes per distinct stored value.
+        void update( int64_t value, int64_t countDelta ) {
+            if( value < 0 || value > maxValue )
+                throw std::runtime_error( "size out of range" );
+
+            int64_t node = 0;
+            for( int64_t bit = numBits - 1; ; bit-- ) {
+                nodes[ node ].count += countDelta;
+                nodes[ node ].sum += countDelta * value;
+                if( bit < 0 )
+                    return;
+
+                const auto direction = value >> bit & 1;
+                auto child = nodes[ node ].children[ direction ];
+                if( child == -1 ) {
+                    child = allocateNode();
+                    nodes[ node ].children[ direction ] = child;
+                }
+                else if( nodes[ child ].count + countDelta == 0 ) {
+                    nodes[ node ].children[ direction ] = -1;
+                    freeNodes.push_back( child );
+                    while( bit-- > 0 ) {
+                        child = nodes[ child ].children[ value >> bit & 1 ];
+                        freeNodes.push_back( child );
+                    }
+                    return;
+                }
+                node = child;
+            }
+        }
+
+        std::vector<Node> nodes;
+        std::vector<int64_t> freeNodes;
+    };
+
+    // Keeps directory sizes up to date while files are added, removed or resized. A change
+    // is propagated up the parent chain and mirrored in a size multiset, so the puzzle
+    // queries no longer need a tree walk.
+    class DirectorySizeIndex
+    {
+        public:
+        explicit DirectorySizeIndex( FlatTree flatTree ) : tree( std::move( flatTree ) ) {
+            calculateDirectorySizes( tree );
+
+            for( int64_t i = 0; i < std::ssize( tree.directories ); i++ ) {
+                auto& directory = tree.directories[ i ];
+                sizes.insert( directory.size );
+                for( int64_t file = directory.firstFile; file < directory.firstFile + directory.numFiles; file++ )
+                    files.emplace( getEntryKey( i, tree.files[ file ].name ), file );
+            }
+
+            fileDirectories.resize( tree.files.size() );
+            for( int64_t i = 0; i < std::ssize( tree.directories ); i++ )
+                for( auto& directory = tree.directories[ i ]; auto& fileDirectory : std::span( fileDirectories ).subspan( directory.firstFile, directory.numFiles ) )
+                    fileDirectory = i;
+        }
+
+        void addFile( int64_t directory, std::string_view name, int64_t size ) {
+            const auto key = getEntryKey( directory, tree.names.intern( name ) );
+            if( files.contains( key ) )
+                throw std::runtime_error( "file already exists" );
+
+            files.emplace( key, std::ssize( tree.files ) );
+            tree.files.push_back( { tree.names.intern( name ), size } );
+            fileDirectories.push_back( directory );
+            propagateSizeChange( directory, size );
+        }
+
+        void removeFile( int64_t directory, std::string_view name ) {
+            const auto key = getEntryKey( directory, tree.names.intern( name ) );
+            const auto fileIndex = getFileIndex( key );
+            auto& file = tree.files[ fileIndex ];
+            propagateSizeChange( directory, -file.size );
+            file.size = 0;
+            fileDirectories[ fileIndex ] = -1;
+            files.erase( key );
+        }
+
+        void setFileSize( int64_t directory, std::string_view name, int64_t size ) {
+            auto& file = getFile( directory, name );
+            propagateSizeChange( directory, size - file.size );
+            file.size = size;
+        }
+
+        int64_t getSumOfDirectories( int64_t maxSize ) const {
+            return sizes.getSumAtMost( maxSize );
+        }
+
+        std::optional<int64_t> getSizeOfDeletedDirectory( int64_t sizeNeeded ) const {
+            return sizes.getSmallestAtLeast( sizeNeeded );
+        }
+
+        // Added files are appended and removed ones only marked, so the tree is rebuilt here
+        // with every directory's live files in its own range again.
+        FlatTree getTree() const {
+            FlatTree snapshot;
+            for( int64_t name = 0; name < tree.names.getNumNames(); name++ )
+                snapshot.names.intern( tree.names.getName( name ) );
+            snapshot.directories = tree.directories;
+            for( auto& directory : snapshot.directories )
+                directory.numFiles = 0;
+            for( auto directory : fileDirectories )
+                if( directory != -1 )
+                    snapshot.directories[ directory ].numFiles++;
+
+            int64_t firstFile = 0;
+            for( auto& directory : snapshot.directories ) {
+                directory.firstFile = firstFile;
+                firstFile += directory.numFiles;
+            }
+
+            snapshot.files.resize( firstFile );
+            std::vector<int64_t> nextFiles( snapshot.directories.size() );
+            for( int64_t i = 0; i < std::ssize( fileDirectories ); i++ ) {
+                if( const auto directory = fileDirectories[ i ]; directory != -1 )
+                    snapshot.files[ snapshot.directories[ directory ].firstFile + nextFiles[ directory ]++ ] = tree.files[ i ];
+            }
+
+            return snapshot;
+        }
+
+        private:
+        int64_t getFileIndex( uint64_t key ) const {
+            const auto file = files.find( key );
+            if( file == files.end() )
+                throw std::runtime_error( "file does not exist" );
+
+            return file->second;
+        }
+
+        FlatFile& getFile( int64_t directory, std::string_view name ) {
+            return tree.files[ getFileIndex( getEntryKey( directory, tree.names.intern( name ) ) ) ];
+        }
+
+        void propagateSizeChange( int64_t directory, int64_t delta ) {
+            for( ; directory != -1; directory = tree.directories[ directory ].parent ) {
+                auto& size = tree.directories[ directory ].size;
+                sizes.erase( size );
+                size += delta;
+                sizes.insert( size );
+            }
+        }
+
+        FlatTree tree;
+        SizeMultiset sizes;
+        std::unordered_map<uint64_t, int64_t> files;
+        std::vector<int64_t> fileDirectories; // -1 once removed
+    };
+
+    struct SizeQuery
+    {
+        int64_t maxSize = 0;
+        int64_t sizeNeeded = 0;
+    };
+
+    // Answers of both puzzle queries, collected while the sizes are computed.
+    struct SizeSummary
+    {
+        int64_t sumOfDirectories = 0;
+        std::optional<int64_t> sizeOfDeletedDirectory;
+
+        void add( int64_t size, const SizeQuery& query ) {
+            if( size <= query.maxSize )
+                sumOfDirectories += size;
+            if( size >= query.sizeNeeded && ( !sizeOfDeletedDirectory || size < *sizeOfDeletedDirectory ) )
+                sizeOfDeletedDirectory = size;
+        }
+
+        void merge( const SizeSummary& other ) {
+            sumOfDirectories += other.sumOfDirectories;
+            if( other.sizeOfDeletedDirectory && ( !sizeOfDeletedDirectory || *other.sizeOfDeletedDirectory < *sizeOfDeletedDirectory ) )
+                sizeOfDeletedDirectory = other.sizeOfDeletedDirectory;
+        }
+    };
+
+    int64_t getTotalFileSize( const FlatTree& tree ) {
+        return ranges::accumulate( tree.files, 0ll, ranges::plus(), &FlatFile::size );
+    }
+
+    void finishDirectory( FlatTree& tree, int64_t index, const SizeQuery& query, SizeSummary& summary ) {
+        auto& directory = tree.directories[ index ];
+        const auto files = std::span( tree.files ).subspan( directory.firstFile, directory.numFiles );
+        const auto subDirectories = std::span( tree.directories ).subspan( directory.firstChild, directory.numChildren );
+
+        directory.size = ranges::accumulate( files, 0ll, ranges::plus(), &FlatFile::size )
+            + ranges::accumulate( subDirectories, 0ll, ranges::plus(), &FlatDirectory::size );
+        summary.add( directory.size, query );
+    }
+
+    // Iterative post-order walk, so deep subtrees do not grow the call stack.
+    void aggregateSubtree( FlatTree& tree, int64_t root, const SizeQuery& query, SizeSummary& summary ) {
+        std::vector<std::pair<int64_t, int64_t>> stack{ { root, 0 } };
+        while( !stack.empty() ) {
+            auto& [index, visitedChildren] = stack.back();
+            const auto& directory = tree.directories[ index ];
+            if( visitedChildren < directory.numChildren ) {
+                const auto child = directory.firstChild + visitedChildren++;
+                stack.push_back( { child, 0 } );
+                continue;
+            }
+
+            finishDirectory( tree, index, query, summary );
+            stack.pop_back();
+        }
+    }
+
+    // Computes all directory sizes and answers both queries in the same walk. Directories with
+    // more than a cutoff of directories below them are split into their children, smaller
+    // subtrees are aggregated serially by the threads in batches of about the cutoff. The split
+    // directories are finished last.
+    SizeSummary aggregateDirectorySizes( FlatTree& tree, const SizeQuery& query, int64_t numThreads = std::thread::hardware_concurrency() ) {
+        constexpr int64_t batchesPerThread = 8;
+        constexpr int64_t minBatchDirectories = 1024;
+
+        SizeSummary summary;
+        if( numThreads <= 1 ) {
+            aggregateSubtree( tree, 0, query, summary );
+            return summary;
+        }
+
+        const auto cutoff = std::max( tree.directories[ 0 ].subtreeDirectories / ( numThreads * batchesPerThread ), minBatchDirectories );
+
+        std::vector<int64_t> split;
+        std::vector<int64_t> subtrees;
+        std::vector<int64_t> pending{ 0 };
+        while( !pending.empty() ) {
+            const auto index = pending.back();
+            pending.pop_back();
+            if( tree.directories[ index ].subtreeDirectories <= cutoff ) {
+                subtrees.push_back( index );
+                continue;
+            }
+
+            split.push_back( index );
+            const auto& directory = tree.directories[ index ];
+            for( int64_t child = directory.firstChild; child < directory.firstChild + directory.numChildren; child++ )
+                pending.push_back( child );
+        }
+
+        std::vector<int64_t> batchEnds;
+        int64_t batchDirectories = 0;
+        for( int64_t i = 0; i < std::ssize( subtrees ); i++ ) {
+            batchDirectories += tree.directories[ subtrees[ i ] ].subtreeDirectories;
+            if( batchDirectories >= cutoff || i + 1 == std::ssize( subtrees ) ) {
+                batchEnds.push_back( i + 1 );
+                batchDirectories = 0;
+            }
+        }
+
+        std::vector<SizeSummary> summaries( numThreads );
+        std::atomic<int64_t> nextBatch = 0;
+        auto aggregateBatches = [&] ( SizeSummary& threadSummary ) {
+            SizeSummary batchSummary;
+            for( int64_t batch = nextBatch++; batch < std::ssize( batchEnds ); batch = nextBatch++ )
+                for( int64_t i = batch == 0 ? 0 : batchEnds[ batch - 1 ]; i < batchEnds[ batch ]; i++ )
+                    aggregateSubtree( tree, subtrees[ i ], query, batchSummary );
+            threadSummary = batchSummary;
+        };
+
+        {
+            std::vector<std::jthread> threads;
+            for( int64_t i = 1; i < std::min( numThreads, std::ssize( batchEnds ) ); i++ )
+                threads.emplace_back( aggregateBatches, std::ref( summaries[ i ] ) );
+            aggregateBatches( summaries[ 0 ] );
+        }
+
+        for( auto& threadSummary : summaries )
+            summary.merge( threadSummary );
+        // Split directories were collected parents first
+        for( auto index : split | ranges::views::reverse )
+            finishDirectory( tree, index, query, summary );
+
+        return summary;
+    }
+
     void execute() {
         std::ifstream file( "input/Day7.txt" );
-        auto commands = parseInput( file );
+        FlatTree tree = parseTree( file );
 
-        Directory tree = buildTree( commands );
-        calculateDirectorySize( tree );
+        int64_t bytesToFree = 30'000'000 - ( 70'000'000 - getTotalFileSize( tree ) );
+        const auto summary = aggregateDirectorySizes( tree, { 100'000, bytesToFree } );
 
-        fmt::print( "Day 6: Sum of directories with max size 100'000: {}\n", calculateSumOfDirectories( tree, 100'000 ) );
-        
-        int64_t bytesToFree = 30'000'000 - ( 70'000'000 - tree.size.value() );
-        fmt::print( "Day 6: Size of deleted directory: {}\n", getSizeOfDeletedDirectory( tree, bytesToFree ).value() );
+        fmt::print( "Day 6: Sum of directories with max size 100'000: {}\n", summary.sumOfDirectories );
+        fmt::print( "Day 6: Size of deleted directory: {}\n", summary.sizeOfDeletedDirectory.value() );
     }
 }
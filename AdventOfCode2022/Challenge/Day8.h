@@ -9,6 +9,12 @@
 #include <fmt/core.h>
 #include <set>
 #include <optional>
+#include <array>
+#include <span>
+#include <bit>
+#include <atomic>
+#include <thread>
+#include <stdexcept>
 
 namespace Day8
 {
@@ -38,6 +44,16 @@ namespace Day8
 
             return data[ x + y * width.value() ];
         }
+        void set( Vec2 pos, char treeHeight ) {
+            auto& [x, y] = pos;
+            if( x >= width || x < 0 || y >= height || y < 0 )
+                throw std::runtime_error( "invalid index" );
+
+            data[ x + y * width.value() ] = treeHeight;
+        }
+        std::span<const char> getRow( int64_t y ) const {
+            return std::span( data ).subspan( y * width.value(), width.value() );
+        }
         int64_t getWidth() const {
             return width.value();
         }
@@ -100,6 +116,89 @@ namespace Day8
         return visibleTrees.size();
     }
 
+    // One bit per tree, each row padded to whole 64-bit words.
+    class TreeBitset
+    {
+        public:
+        TreeBitset( int64_t width, int64_t height )
+            : wordsPerRow( ( width + 63 ) / 64 ), words( wordsPerRow * height ) {}
+
+        bool test( Vec2 pos ) const {
+            return words[ pos.y * wordsPerRow + pos.x / 64 ] >> ( pos.x % 64 ) & 1;
+        }
+
+        // Ors a row of 0/1 flags into the bits of row y, starting at column xStart (multiple of 64).
+        void orRow( int64_t y, std::span<const uint8_t> flags, int64_t xStart = 0 ) {
+            auto* rowWords = words.data() + y * wordsPerRow + xStart / 64;
+            for( int64_t word = 0; word < ( std::ssize( flags ) + 63 ) / 64; word++ ) {
+                const auto wordFlags = flags.subspan( word * 64, std::min<int64_t>( 64, std::ssize( flags ) - word * 64 ) );
+                uint64_t bits = 0;
+                for( int64_t bit = 0; bit < std::ssize( wordFlags ); bit++ )
+                    bits |= uint64_t( wordFlags[ bit ] ) << bit;
+                rowWords[ word ] |= bits;
+            }
+        }
+
+        int64_t count() const {
+            return ranges::accumulate( words, 0ll, ranges::plus(), [] ( uint64_t word ) { return std::popcount( word ); } );
+        }
+
+        private:
+        int64_t wordsPerRow = 0;
+        std::vector<uint64_t> words;
+    };
+
+    // Running max of each column over all rows seen so far, updated a whole row at a time.
+    // Returns for each tree in the row whether it is higher than everything before it.
+    void updateColumnMax( std::span<const char> row, std::span<int8_t> columnMax, std::span<uint8_t> visible ) {
+        for( int64_t x = 0; x < std::ssize( row ); x++ ) {
+            const int8_t treeHeight = row[ x ];
+            const int8_t previousMax = columnMax[ x ];
+            visible[ x ] = treeHeight > previousMax;
+            columnMax[ x ] = std::max( previousMax, treeHeight );
+        }
+    }
+
+    void updateRowMax( std::span<const char> row, std::span<uint8_t> visible ) {
+        int8_t leftMax = -1;
+        for( int64_t x = 0; x < std::ssize( row ); x++ ) {
+            visible[ x ] |= row[ x ] > leftMax;
+            leftMax = std::max<int8_t>( leftMax, row[ x ] );
+        }
+
+        int8_t rightMax = -1;
+        for( int64_t x = std::ssize( row ) - 1; x >= 0; x-- ) {
+            visible[ x ] |= row[ x ] > rightMax;
+            rightMax = std::max<int8_t>( rightMax, row[ x ] );
+        }
+    }
+
+    // Visibility of all trees as a bitset. The top and bottom sweeps keep a running max row
+    // and process whole rows at once, so the compiler can vectorize them.
+    TreeBitset calculateVisibility( const TreeMap& treeMap ) {
+        const auto width = treeMap.getWidth();
+        const auto height = treeMap.getHeight();
+
+        TreeBitset visibleTrees( width, height );
+        std::vector<uint8_t> visible( width );
+
+        std::vector<int8_t> columnMax( width, -1 );
+        for( int64_t y = 0; y < height; y++ ) {
+            const auto row = treeMap.getRow( y );
+            updateColumnMax( row, columnMax, visible );
+            updateRowMax( row, visible );
+            visibleTrees.orRow( y, visible );
+        }
+
+        columnMax.assign( width, -1 );
+        for( int64_t y = height - 1; y >= 0; y-- ) {
+            updateColumnMax( treeMap.getRow( y ), columnMax, visible );
+            visibleTrees.orRow( y, visible );
+        }
+
+        return visibleTrees;
+    }
+
     int64_t getBottomScore( const TreeMap& treeMap, Vec2 pos ) {
         int64_t score = 0;
         auto treeSize = treeMap.get( pos );
@@ -162,11 +261,402 @@ namespace Day8
         return maxScore;
     }
 
+    constexpr int64_t numTreeHeights = 10;
+
+    struct ScenicScores
+    {
+        int64_t maxScore = 0;
+        std::vector<int64_t> scores; // row-major, only filled on request
+    };
+
+    // Viewing distances along a line. For every height it keeps the last position of a
+    // tree at least that high, the view of a tree ends at the last blocker of its height.
+    class ViewingDistances
+    {
+        public:
+        explicit ViewingDistances( int64_t edge ) {
+            lastBlocker.fill( edge );
+        }
+
+        // Continues a line whose last blocker per height is already known
+        explicit ViewingDistances( std::span<const int32_t> blockers ) {
+            ranges::copy( blockers, lastBlocker.begin() );
+        }
+
+        int64_t update( char treeHeight, int64_t pos ) {
+            const auto distance = std::abs( pos - lastBlocker[ treeHeight ] );
+            std::fill( lastBlocker.begin(), lastBlocker.begin() + treeHeight + 1, pos );
+            return distance;
+        }
+
+        private:
+        std::array<int64_t, numTreeHeights> lastBlocker;
+    };
+
+    // Computes all scenic scores in linear time: one pass down the rows stores the upward
+    // distances, one pass up the rows combines them with the other three directions.
+    ScenicScores calculateScenicScores( const TreeMap& treeMap, bool keepScores = false ) {
+        const auto width = treeMap.getWidth();
+        const auto height = treeMap.getHeight();
+
+        ScenicScores result;
+        if( keepScores )
+            result.scores.resize( width * height );
+
+        std::vector<int32_t> upDistances( width * height );
+        std::vector<ViewingDistances> columns( width, ViewingDistances( 0 ) );
+        for( int64_t y = 0; y < height; y++ ) {
+            const auto row = treeMap.getRow( y );
+            for( int64_t x = 0; x < width; x++ )
+                upDistances[ x + y * width ] = static_cast<int32_t>( columns[ x ].update( row[ x ], y ) );
+        }
+
+        std::vector<int64_t> rowScores( width );
+        columns.assign( width, ViewingDistances( height - 1 ) );
+        for( int64_t y = height - 1; y >= 0; y-- ) {
+            const auto row = treeMap.getRow( y );
+
+            ViewingDistances left( 0 );
+            for( int64_t x = 0; x < width; x++ )
+                rowScores[ x ] = upDistances[ x + y * width ] * columns[ x ].update( row[ x ], y ) * left.update( row[ x ], x );
+
+            ViewingDistances right( width - 1 );
+            for( int64_t x = width - 1; x >= 0; x-- ) {
+                rowScores[ x ] *= right.update( row[ x ], x );
+                result.maxScore = std::max( result.maxScore, rowScores[ x ] );
+            }
+
+            if( keepScores )
+                ranges::copy( rowScores, result.scores.begin() + y * width );
+        }
+
+        return result;
+    }
+
+    template<typename Function>
+    void parallelFor( int64_t numTasks, int64_t numThreads, Function function ) {
+        std::atomic<int64_t> nextTask = 0;
+        auto runTasks = [&] () {
+            for( int64_t task = nextTask++; task < numTasks; task = nextTask++ )
+                function( task );
+        };
+
+        std::vector<std::jthread> threads;
+        for( int64_t i = 1; i < std::min( numThreads, numTasks ); i++ )
+            threads.emplace_back( runTasks );
+        runTasks();
+    }
+
+    // The parallel passes split the map into bands of whole rows, a few per thread. Rows
+    // stay contiguous like in the serial passes and every band owns whole words of the bitset.
+    // The vertical passes need the state of the rows above and below a band, so a cheap first
+    // pass summarizes every band and a serial scan over the summaries gives each band the
+    // state it starts with. With one thread the serial passes run directly.
+    constexpr int64_t bandsPerThread = 4;
+
+    struct Band
+    {
+        int64_t yStart = 0;
+        int64_t yEnd = 0;
+    };
+
+    std::vector<Band> getBands( int64_t height, int64_t numThreads ) {
+        const auto numBands = std::clamp<int64_t>( numThreads * bandsPerThread, 1, std::max<int64_t>( height, 1 ) );
+        std::vector<Band> bands;
+        for( int64_t band = 0; band < numBands; band++ )
+            bands.push_back( { band * height / numBands, ( band + 1 ) * height / numBands } );
+        return bands;
+    }
+
+    TreeBitset calculateVisibilityParallel( const TreeMap& treeMap, int64_t numThreads = std::thread::hardware_concurrency() ) {
+        if( numThreads <= 1 )
+            return calculateVisibility( treeMap );
+
+        const auto width = treeMap.getWidth();
+        const auto height = treeMap.getHeight();
+        const auto bands = getBands( height, numThreads );
+        const auto numBands = std::ssize( bands );
+
+        // Column max of every band, then turned into the max of all bands above and below it
+        std::vector<int8_t> topMax( numBands * width, -1 );
+        parallelFor( numBands, numThreads, [&] ( int64_t band ) {
+            const auto columnMax = std::span( topMax ).subspan( band * width, width );
+            for( int64_t y = bands[ band ].yStart; y < bands[ band ].yEnd; y++ ) {
+                const auto row = treeMap.getRow( y );
+                for( int64_t x = 0; x < width; x++ )
+                    columnMax[ x ] = std::max<int8_t>( columnMax[ x ], row[ x ] );
+            }
+        } );
+
+        std::vector<int8_t> bottomMax( numBands * width, -1 );
+        std::vector<int8_t> runningMax( width, -1 );
+        for( int64_t band = numBands - 1; band >= 0; band-- ) {
+            for( int64_t x = 0; x < width; x++ ) {
+                bottomMax[ band * width + x ] = runningMax[ x ];
+                runningMax[ x ] = std::max( runningMax[ x ], topMax[ band * width + x ] );
+            }
+        }
+        runningMax.assign( width, -1 );
+        for( int64_t band = 0; band < numBands; band++ ) {
+            for( int64_t x = 0; x < width; x++ ) {
+                const auto bandMax = topMax[ band * width + x ];
+                topMax[ band * width + x ] = runningMax[ x ];
+                runningMax[ x ] = std::max( runningMax[ x ], bandMax );
+            }
+        }
+
+        TreeBitset visibleTrees( width, height );
+        parallelFor( numBands, numThreads, [&] ( int64_t band ) {
+            const auto [yStart, yEnd] = bands[ band ];
+            std::vector<uint8_t> visible( width );
+
+            std::vector<int8_t> columnMax( topMax.begin() + band * width, topMax.begin() + ( band + 1 ) * width );
+            for( int64_t y = yStart; y < yEnd; y++ ) {
+                const auto row = treeMap.getRow( y );
+                updateColumnMax( row, columnMax, visible );
+                updateRowMax( row, visible );
+                visibleTrees.orRow( y, visible );
+            }
+
+            ranges::copy( std::span( bottomMax ).subspan( band * width, width ), columnMax.begin() );
+            for( int64_t y = yEnd - 1; y >= yStart; y-- ) {
+                updateColumnMax( treeMap.getRow( y ), columnMax, visible );
+                visibleTrees.orRow( y, visible );
+            }
+        } );
+
+        return visibleTrees;
+    }
+
+    // Same passes as calculateScenicScores within every band. A band's summary holds, per
+    // column and height, the first and the last row of the band with a tree at least that
+    // high. Both follow from a running column max, which rarely changes after a few rows.
+    int64_t getMaxTreeScoreParallel( const TreeMap& treeMap, int64_t numThreads = std::thread::hardware_concurrency() ) {
+        if( numThreads <= 1 )
+            return calculateScenicScores( treeMap ).maxScore;
+
+        const auto width = treeMap.getWidth();
+        const auto height = treeMap.getHeight();
+        const auto bands = getBands( height, numThreads );
+        const auto numBands = std::ssize( bands );
+        const auto bandStateSize = width * numTreeHeights;
+
+        std::vector<int32_t> firstAtLeast( numBands * bandStateSize, -1 );
+        std::vector<int32_t> lastAtLeast( numBands * bandStateSize, -1 );
+        parallelFor( numBands, numThreads, [&] ( int64_t band ) {
+            const auto [yStart, yEnd] = bands[ band ];
+            auto* first = firstAtLeast.data() + band * bandStateSize;
+            auto* last = lastAtLeast.data() + band * bandStateSize;
+            std::vector<int8_t> columnMax( width, -1 );
+            for( int64_t y = yStart; y < yEnd; y++ ) {
+                const auto row = treeMap.getRow( y );
+                for( int64_t x = 0; x < width; x++ ) {
+                    for( int8_t h = columnMax[ x ] + 1; h <= row[ x ]; h++ )
+                        first[ x * numTreeHeights + h ] = static_cast<int32_t>( y );
+                    columnMax[ x ] = std::max<int8_t>( columnMax[ x ], row[ x ] );
+                }
+            }
+
+            columnMax.assign( width, -1 );
+            for( int64_t y = yEnd - 1; y >= yStart; y-- ) {
+                const auto row = treeMap.getRow( y );
+                for( int64_t x = 0; x < width; x++ ) {
+                    for( int8_t h = columnMax[ x ] + 1; h <= row[ x ]; h++ )
+                        last[ x * numTreeHeights + h ] = static_cast<int32_t>( y );
+                    columnMax[ x ] = std::max<int8_t>( columnMax[ x ], row[ x ] );
+                }
+            }
+        } );
+
+        // In place: the last rows become the blockers above each band, the first rows the
+        // blockers below it, falling back to the edges of the map
+        std::vector<int32_t> blockers( bandStateSize, 0 );
+        for( int64_t band = 0; band < numBands; band++ ) {
+            for( int64_t i = 0; i < bandStateSize; i++ ) {
+                const auto lastRow = lastAtLeast[ band * bandStateSize + i ];
+                lastAtLeast[ band * bandStateSize + i ] = blockers[ i ];
+                if( lastRow != -1 )
+                    blockers[ i ] = lastRow;
+            }
+        }
+        blockers.assign( bandStateSize, static_cast<int32_t>( height - 1 ) );
+        for( int64_t band = numBands - 1; band >= 0; band-- ) {
+            for( int64_t i = 0; i < bandStateSize; i++ ) {
+                const auto firstRow = firstAtLeast[ band * bandStateSize + i ];
+                firstAtLeast[ band * bandStateSize + i ] = blockers[ i ];
+                if( firstRow != -1 )
+                    blockers[ i ] = firstRow;
+            }
+        }
+
+        std::vector<int64_t> bandMaxScores( numBands );
+        parallelFor( numBands, numThreads, [&] ( int64_t band ) {
+            const auto [yStart, yEnd] = bands[ band ];
+            const auto upBlockers = std::span( lastAtLeast ).subspan( band * bandStateSize, bandStateSize );
+            const auto downBlockers = std::span( firstAtLeast ).subspan( band * bandStateSize, bandStateSize );
+
+            std::vector<ViewingDistances> columns;
+            columns.reserve( width );
+            for( int64_t x = 0; x < width; x++ )
+                columns.emplace_back( upBlockers.subspan( x * numTreeHeights, numTreeHeights ) );
+
+            std::vector<int32_t> upDistances( ( yEnd - yStart ) * width );
+            for( int64_t y = yStart; y < yEnd; y++ ) {
+                const auto row = treeMap.getRow( y );
+                for( int64_t x = 0; x < width; x++ )
+                    upDistances[ x + ( y - yStart ) * width ] = static_cast<int32_t>( columns[ x ].update( row[ x ], y ) );
+            }
+
+            for( int64_t x = 0; x < width; x++ )
+                columns[ x ] = ViewingDistances( downBlockers.subspan( x * numTreeHeights, numTreeHeights ) );
+
+            int64_t maxScore = 0;
+            std::vector<int64_t> rowScores( width );
+            for( int64_t y = yEnd - 1; y >= yStart; y-- ) {
+                const auto row = treeMap.getRow( y );
+
+                ViewingDistances left( 0 );
+                for( int64_t x = 0; x < width; x++ )
+                    rowScores[ x ] = upDistances[ x + ( y - yStart ) * width ] * columns[ x ].update( row[ x ], y ) * left.update( row[ x ], x );
+
+                ViewingDistances right( width - 1 );
+                for( int64_t x = width - 1; x >= 0; x-- )
+                    maxScore = std::max( maxScore, rowScores[ x ] * right.update( row[ x ], x ) );
+            }
+            bandMaxScores[ band ] = maxScore;
+        } );
+
+        return ranges::max( bandMaxScores );
+    }
+
+    // Forest that keeps visibility and scenic scores up to date while tree heights change.
+    // A tree's visibility and score only depend on its row and column, so an edit only
+    // recomputes the horizontal data of its row and the vertical data of its column.
+    class ForestModel
+    {
+        public:
+        explicit ForestModel( TreeMap map )
+            : treeMap( std::move( map ) ), width( treeMap.getWidth() ), height( treeMap.getHeight() ),
+            horizontalScores( width * height ), verticalScores( width * height ),
+            horizontalVisible( width * height ), verticalVisible( width * height ),
+            maxScores( 2 * width * height ) {
+            for( int64_t y = 0; y < height; y++ )
+                updateRow( y );
+            for( int64_t x = 0; x < width; x++ )
+                updateColumn( x );
+
+            for( int64_t i = 0; i < width * height; i++ ) {
+                numVisible += isVisible( i );
+                maxScores[ width * height + i ] = getScore( i );
+            }
+            for( int64_t node = width * height - 1; node > 0; node-- )
+                maxScores[ node ] = std::max( maxScores[ 2 * node ], maxScores[ 2 * node + 1 ] );
+        }
+
+        void setHeight( Vec2 pos, char treeHeight ) {
+            if( treeHeight < 0 || treeHeight >= numTreeHeights )
+                throw std::runtime_error( "invalid tree height" );
+            treeMap.set( pos, treeHeight );
+
+            for( int64_t x = 0; x < width; x++ )
+                numVisible -= isVisible( x + pos.y * width );
+            for( int64_t y = 0; y < height; y++ )
+                numVisible -= y != pos.y && isVisible( pos.x + y * width );
+
+            updateRow( pos.y );
+            updateColumn( pos.x );
+
+            for( int64_t x = 0; x < width; x++ )
+                updateCell( x + pos.y * width );
+            for( int64_t y = 0; y < height; y++ )
+                if( y != pos.y )
+                    updateCell( pos.x + y * width );
+        }
+
+        int64_t getNumVisibleTrees() const {
+            return numVisible;
+        }
+
+        int64_t getMaxTreeScore() const {
+            return maxScores[ 1 ];
+        }
+
+        private:
+        bool isVisible( int64_t index ) const {
+            return horizontalVisible[ index ] | verticalVisible[ index ];
+        }
+
+        int64_t getScore( int64_t index ) const {
+            return int64_t( horizontalScores[ index ] ) * verticalScores[ index ];
+        }
+
+        void updateCell( int64_t index ) {
+            numVisible += isVisible( index );
+
+            auto node = width * height + index;
+            maxScores[ node ] = getScore( index );
+            for( node /= 2; node > 0; node /= 2 )
+                maxScores[ node ] = std::max( maxScores[ 2 * node ], maxScores[ 2 * node + 1 ] );
+        }
+
+        void updateRow( int64_t y ) {
+            const auto row = treeMap.getRow( y );
+            auto* scores = horizontalScores.data() + y * width;
+            auto* visible = horizontalVisible.data() + y * width;
+
+            ViewingDistances left( 0 );
+            int8_t leftMax = -1;
+            for( int64_t x = 0; x < width; x++ ) {
+                scores[ x ] = static_cast<uint32_t>( left.update( row[ x ], x ) );
+                visible[ x ] = row[ x ] > leftMax;
+                leftMax = std::max<int8_t>( leftMax, row[ x ] );
+            }
+
+            ViewingDistances right( width - 1 );
+            int8_t rightMax = -1;
+            for( int64_t x = width - 1; x >= 0; x-- ) {
+                scores[ x ] *= static_cast<uint32_t>( right.update( row[ x ], x ) );
+                visible[ x ] |= row[ x ] > rightMax;
+                rightMax = std::max<int8_t>( rightMax, row[ x ] );
+            }
+        }
+
+        void updateColumn( int64_t x ) {
+            ViewingDistances up( 0 );
+            int8_t topMax = -1;
+            for( int64_t y = 0; y < height; y++ ) {
+                const auto treeHeight = treeMap.get( { x, y } );
+                verticalScores[ x + y * width ] = static_cast<uint32_t>( up.update( treeHeight, y ) );
+                verticalVisible[ x + y * width ] = treeHeight > topMax;
+                topMax = std::max<int8_t>( topMax, treeHeight );
+            }
+
+            ViewingDistances down( height - 1 );
+            int8_t bottomMax = -1;
+            for( int64_t y = height - 1; y >= 0; y-- ) {
+                const auto treeHeight = treeMap.get( { x, y } );
+                verticalScores[ x + y * width ] *= static_cast<uint32_t>( down.update( treeHeight, y ) );
+                verticalVisible[ x + y * width ] |= treeHeight > bottomMax;
+                bottomMax = std::max<int8_t>( bottomMax, treeHeight );
+            }
+        }
+
+        TreeMap treeMap;
+        int64_t width = 0;
+        int64_t height = 0;
+        std::vector<uint32_t> horizontalScores;
+        std::vector<uint32_t> verticalScores;
+        std::vector<uint8_t> horizontalVisible;
+        std::vector<uint8_t> verticalVisible;
+        std::vector<int64_t> maxScores; // segment tree over all scores, leaves start at width * height
+        int64_t numVisible = 0;
+    };
+
     void execute() {
         std::ifstream file( "input/Day8.txt" );
         auto data = parseInput( file );
 
-        fmt::print( "Day 8: Number of visible trees: {}\n", getNumVisibleTrees( data ) );
-        fmt::print( "Day 8: Max tree score: {}\n", getMaxTreeScore( data ) );
+        fmt::print( "Day 8: Number of visible trees: {}\n", calculateVisibility( data ).count() );
+        fmt::print( "Day 8: Max tree score: {}\n", calculateScenicScores( data ).maxScore );
     }
 }
\ No newline at end of file
@@ -9,6 +9,10 @@
 #include <fmt/core.h>
 #include <set>
 #include <optional>
+#include <array>
+#include <bit>
+#include <span>
+#include <unordered_map>
 
 namespace Day9
 {
@@ -94,7 +98,206 @@ namespace Day9
         return false;
     }
 
-    void updateRope( std::vector<Vec2>& rope, Direction direction, std::set<Vec2>& tailVisits ) {
+    // Set of visited cells as a dense bitmap over a bounding box that doubles around its
+    // center when a cell outside is visited. Once the box would get too large the cells move
+    // to a sparse map of 64x64 tiles. Long straight runs are kept as segments until counting.
+    class VisitedCells
+    {
+        public:
+        static constexpr int64_t tileSize = 64;
+        static constexpr int64_t maxDenseCells = 1ll << 30;
+        static constexpr int64_t minStoredRunLength = 64;
+        static constexpr int64_t maxStoredRuns = 1 << 16;
+
+        void insert( Vec2 pos ) {
+            if( !isSparse && !isInside( pos ) )
+                grow( pos );
+
+            if( isSparse ) {
+                auto& tile = tiles[ getTileKey( pos ) ];
+                tile[ pos.y & ( tileSize - 1 ) ] |= 1ull << ( pos.x & ( tileSize - 1 ) );
+                return;
+            }
+
+            const auto x = pos.x - min.x;
+            words[ ( pos.y - min.y ) * wordsPerRow + x / 64 ] |= 1ull << ( x % 64 );
+        }
+
+        // Inserts the cells start + step, start + 2 * step, ..., start + count * step for a step
+        // along one axis. Long runs are only stored, which costs O(1), and drawn when counting
+        // after the runs of each row and column have been merged, so a line that is walked
+        // many times is drawn once.
+        void insertLine( Vec2 start, Vec2 step, int64_t count ) {
+            if( count <= 0 )
+                return;
+
+            const Vec2 end = start + Vec2{ step.x * count, step.y * count };
+            const Vec2 first = std::min( start + step, end );
+            const Vec2 last = std::max( start + step, end );
+            if( count < minStoredRunLength ) {
+                drawLine( first, last );
+                return;
+            }
+
+            if( step.y == 0 )
+                rowRuns.push_back( { first.y, first.x, last.x } );
+            else
+                columnRuns.push_back( { first.x, first.y, last.y } );
+
+            if( std::ssize( rowRuns ) + std::ssize( columnRuns ) >= maxStoredRuns )
+                drawRuns();
+        }
+
+        int64_t count() {
+            drawRuns();
+
+            auto popcount = [] ( uint64_t word ) -> int64_t { return std::popcount( word ); };
+            if( !isSparse )
+                return ranges::accumulate( words, 0ll, ranges::plus(), popcount );
+
+            int64_t numCells = 0;
+            for( auto& [key, tile] : tiles )
+                numCells += ranges::accumulate( tile, 0ll, ranges::plus(), popcount );
+            return numCells;
+        }
+
+        private:
+        using Tile = std::array<uint64_t, tileSize>;
+
+        // Cells first to last of one row or column, both included
+        struct Run
+        {
+            int64_t line = 0;
+            int64_t first = 0;
+            int64_t last = 0;
+
+            auto operator<=>( const Run& other ) const = default;
+        };
+
+        static uint64_t getBitMask( int64_t lowBit, int64_t highBit ) {
+            return ( ~0ull >> ( 63 - highBit ) ) & ( ~0ull << lowBit );
+        }
+
+        // Marks the cells from first to last, which share a row or a column. Horizontal lines
+        // are set a word at a time.
+        void drawLine( Vec2 first, Vec2 last ) {
+            insert( first );
+            insert( last );
+            if( isSparse ) {
+                if( first.y == last.y ) {
+                    for( int64_t wordStart = first.x >> 6 << 6; wordStart <= last.x; wordStart += 64 ) {
+                        auto& tile = tiles[ getTileKey( { wordStart, first.y } ) ];
+                        tile[ first.y & ( tileSize - 1 ) ] |= getBitMask( std::max( first.x, wordStart ) - wordStart, std::min( last.x, wordStart + 63 ) - wordStart );
+                    }
+                    return;
+                }
+
+                // Consecutive cells mostly share a tile, so only look it up when it changes.
+                Tile* tile = nullptr;
+                for( int64_t y = first.y; y <= last.y; y++ ) {
+                    if( !tile || ( y & ( tileSize - 1 ) ) == 0 )
+                        tile = &tiles[ getTileKey( { first.x, y } ) ];
+                    ( *tile )[ y & ( tileSize - 1 ) ] |= 1ull << ( first.x & ( tileSize - 1 ) );
+                }
+                return;
+            }
+
+            if( first.x == last.x ) {
+                const auto x = first.x - min.x;
+                for( int64_t row = first.y - min.y; row <= last.y - min.y; row++ )
+                    words[ row * wordsPerRow + x / 64 ] |= 1ull << ( x % 64 );
+                return;
+            }
+
+            const auto firstBit = first.x - min.x;
+            const auto lastBit = last.x - min.x;
+            auto* rowWords = words.data() + ( first.y - min.y ) * wordsPerRow;
+            for( int64_t word = firstBit / 64; word <= lastBit / 64; word++ )
+                rowWords[ word ] |= getBitMask( std::max( firstBit, word * 64 ) - word * 64, std::min( lastBit, word * 64 + 63 ) - word * 64 );
+        }
+
+        void drawRuns() {
+            auto drawMerged = [&] ( std::vector<Run>& runs, auto drawRun ) {
+                ranges::sort( runs );
+                for( int64_t i = 0; i < std::ssize( runs ); ) {
+                    auto merged = runs[ i ];
+                    for( i++; i < std::ssize( runs ) && runs[ i ].line == merged.line && runs[ i ].first <= merged.last + 1; i++ )
+                        merged.last = std::max( merged.last, runs[ i ].last );
+                    drawRun( merged );
+                }
+                runs.clear();
+            };
+
+            drawMerged( rowRuns, [&] ( const Run& run ) { drawLine( { run.first, run.line }, { run.last, run.line } ); } );
+            drawMerged( columnRuns, [&] ( const Run& run ) { drawLine( { run.line, run.first }, { run.line, run.last } ); } );
+        }
+
+        bool isInside( Vec2 pos ) const {
+            return pos.x >= min.x && pos.x < min.x + size.x && pos.y >= min.y && pos.y < min.y + size.y;
+        }
+
+        static uint64_t getTileKey( Vec2 pos ) {
+            return static_cast<uint64_t>( static_cast<uint32_t>( pos.x >> 6 ) ) << 32 | static_cast<uint32_t>( pos.y >> 6 );
+        }
+
+        void grow( Vec2 pos ) {
+            Vec2 newMin = min;
+            Vec2 newSize = size;
+            // The box starts aligned to tiles and sizes stay powers of two of at least 128,
+            // so growing moves it by whole tiles.
+            if( words.empty() ) {
+                newSize = { 2 * tileSize, 2 * tileSize };
+                newMin = { ( pos.x >> 6 << 6 ) - tileSize, ( pos.y >> 6 << 6 ) - tileSize };
+            }
+            for( ; pos.x < newMin.x || pos.x >= newMin.x + newSize.x; newSize.x *= 2 )
+                newMin.x -= newSize.x / 2;
+            for( ; pos.y < newMin.y || pos.y >= newMin.y + newSize.y; newSize.y *= 2 )
+                newMin.y -= newSize.y / 2;
+
+            if( newSize.x * newSize.y > maxDenseCells ) {
+                moveToTiles();
+                return;
+            }
+
+            const auto newWordsPerRow = newSize.x / 64;
+            std::vector<uint64_t> newWords( newWordsPerRow * newSize.y );
+            const auto wordOffset = ( min.x - newMin.x ) / 64;
+            for( int64_t y = 0; y < size.y; y++ )
+                ranges::copy( std::span( words ).subspan( y * wordsPerRow, wordsPerRow ),
+                    newWords.begin() + ( y + min.y - newMin.y ) * newWordsPerRow + wordOffset );
+
+            words = std::move( newWords );
+            wordsPerRow = newWordsPerRow;
+            min = newMin;
+            size = newSize;
+        }
+
+        void moveToTiles() {
+            // The box is aligned to tiles, so every bitmap word maps onto one tile row.
+            for( int64_t y = 0; y < size.y; y++ ) {
+                for( int64_t word = 0; word < wordsPerRow; word++ ) {
+                    if( const auto bits = words[ y * wordsPerRow + word ] ) {
+                        const Vec2 pos = min + Vec2{ word * 64, y };
+                        tiles[ getTileKey( pos ) ][ pos.y & ( tileSize - 1 ) ] |= bits;
+                    }
+                }
+            }
+
+            words.clear();
+            isSparse = true;
+        }
+
+        Vec2 min;
+        Vec2 size;
+        int64_t wordsPerRow = 0;
+        std::vector<uint64_t> words;
+        bool isSparse = false;
+        std::unordered_map<uint64_t, Tile> tiles;
+        std::vector<Run> rowRuns;
+        std::vector<Run> columnRuns;
+    };
+
+    void updateRope( std::vector<Vec2>& rope, Direction direction, VisitedCells& tailVisits ) {
         rope.front() = getPositionAfterStep( direction, rope.front() );
 
         for( int64_t i = 1; i < std::ssize( rope ); i++ )
@@ -104,26 +307,94 @@ namespace Day9
         tailVisits.insert( rope.back() );
     }
 
-    void executeRopeStep( std::vector<Vec2>& rope, Command command, std::set<Vec2>& tailVisits ) {
+    void executeRopeStep( std::vector<Vec2>& rope, Command command, VisitedCells& tailVisits ) {
         for( int64_t steps = 0; steps < command.distance; steps++ )
             updateRope( rope, command.direction, tailVisits );
     }
 
     int64_t getNumTailVisits( const std::vector<Command>& commands, int64_t ropeLength ) {
-        std::set<Vec2> tailPositions{ {0,0} };
+        VisitedCells tailPositions;
+        tailPositions.insert( { 0,0 } );
         std::vector<Vec2> rope( ropeLength, Vec2() );
 
         for( auto& command : commands )
             executeRopeStep( rope, command, tailPositions );
 
-        return std::ssize( tailPositions );
+        return tailPositions.count();
+    }
+
+    // Knot positions of a rope in structure-of-arrays layout.
+    struct Rope
+    {
+        std::vector<int32_t> x;
+        std::vector<int32_t> y;
+    };
+
+    // Extends the number of leading knots that trail the previous one by exactly one step.
+    // During a motion such a prefix only grows, once it covers the rope each step just
+    // shifts the whole rope.
+    int64_t extendStraightKnots( const Rope& rope, Vec2 step, int64_t straightKnots ) {
+        while( straightKnots < std::ssize( rope.x ) && rope.x[ straightKnots - 1 ] - rope.x[ straightKnots ] == step.x
+            && rope.y[ straightKnots - 1 ] - rope.y[ straightKnots ] == step.y )
+            straightKnots++;
+
+        return straightKnots;
+    }
+
+    // Knot k of a rope moves exactly like the tail of a rope of length k + 1, so a single
+    // simulation of the longest rope gives the tail visits for every shorter length as well.
+    // Element k of the result is the number of cells visited by knot k, which equals
+    // getNumTailVisits( commands, k + 1 ).
+    std::vector<int64_t> getNumKnotVisits( const std::vector<Command>& commands, int64_t ropeLength ) {
+        Rope rope{ std::vector<int32_t>( ropeLength ), std::vector<int32_t>( ropeLength ) };
+        std::vector<VisitedCells> knotVisits( ropeLength );
+        for( auto& visits : knotVisits )
+            visits.insert( { 0,0 } );
+
+        for( auto& command : commands ) {
+            const auto [stepX, stepY] = getPositionAfterStep( command.direction, Vec2() );
+            int64_t straightKnots = 1;
+            for( int64_t step = 0; step < command.distance; step++ ) {
+                // Once the rope is straight along the motion, advance the rest of the run at once.
+                straightKnots = extendStraightKnots( rope, { stepX, stepY }, straightKnots );
+                if( straightKnots >= ropeLength ) {
+                    const auto remainingSteps = command.distance - step;
+                    for( int64_t knot = 0; knot < ropeLength; knot++ ) {
+                        knotVisits[ knot ].insertLine( { rope.x[ knot ], rope.y[ knot ] }, { stepX, stepY }, remainingSteps );
+                        rope.x[ knot ] += static_cast<int32_t>( stepX * remainingSteps );
+                        rope.y[ knot ] += static_cast<int32_t>( stepY * remainingSteps );
+                    }
+                    break;
+                }
+
+                rope.x[ 0 ] += static_cast<int32_t>( stepX );
+                rope.y[ 0 ] += static_cast<int32_t>( stepY );
+                knotVisits[ 0 ].insert( { rope.x[ 0 ], rope.y[ 0 ] } );
+
+                for( int64_t knot = 1; knot < ropeLength; knot++ ) {
+                    const auto diffX = rope.x[ knot - 1 ] - rope.x[ knot ];
+                    const auto diffY = rope.y[ knot - 1 ] - rope.y[ knot ];
+                    if( std::abs( diffX ) <= 1 && std::abs( diffY ) <= 1 )
+                        break;
+
+                    rope.x[ knot ] += std::clamp( diffX, -1, 1 );
+                    rope.y[ knot ] += std::clamp( diffY, -1, 1 );
+                    knotVisits[ knot ].insert( { rope.x[ knot ], rope.y[ knot ] } );
+                }
+            }
+        }
+
+        return knotVisits
+            | ranges::views::transform( [] ( VisitedCells& visits ) { return visits.count(); } )
+            | ranges::to_vector;
     }
 
     void execute() {
         std::ifstream file( "input/Day9.txt" );
         auto commands = parseInput( file );
+        const auto knotVisits = getNumKnotVisits( commands, 10 );
 
-        fmt::print( "Day9: number of tail visit: {}\n", getNumTailVisits( commands, 2 ) );
-        fmt::print( "Day9: number of tail visit for long rope: {}\n", getNumTailVisits( commands, 10 ) );
+        fmt::print( "Day9: number of tail visit: {}\n", knotVisits[ 1 ] );
+        fmt::print( "Day9: number of tail visit for long rope: {}\n", knotVisits[ 9 ] );
     }
 }
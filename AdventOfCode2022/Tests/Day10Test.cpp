@@ -0,0 +1,105 @@
+#include "../Challenge/Day10.h"
+
+#include <random>
+
+namespace
+{
+    int64_t numFailures = 0;
+
+    void check( int64_t expected, int64_t actual, const std::string& name ) {
+        if( expected == actual )
+            return;
+        fmt::print( "FAILED {}: expected {}, got {}\n", name, expected, actual );
+        numFailures++;
+    }
+
+    void check( const std::string& expected, const std::string& actual, const std::string& name ) {
+        if( expected == actual )
+            return;
+        fmt::print( "FAILED {}: screens differ\n", name );
+        numFailures++;
+    }
+
+    std::vector<Day10::Operation> generateProgram( std::mt19937& random, int64_t numOperations ) {
+        std::vector<Day10::Operation> operations;
+        for( int64_t i = 0; i < numOperations; i++ ) {
+            if( random() % 3 == 0 )
+                operations.push_back( Day10::NOOP{} );
+            else
+                operations.push_back( Day10::AddOperation{ static_cast<int64_t>( random() % 81 ) - 40 } );
+        }
+        return operations;
+    }
+
+    // Trace against interpreting the operations, including cycles after the end of the program
+    void testCycleTrace() {
+        std::mt19937 random( 10 );
+        for( int64_t i = 0; i < 200; i++ ) {
+            const auto operations = generateProgram( random, random() % 300 );
+            const Day10::CycleTrace trace( operations );
+            const auto name = fmt::format( "trace {}", i );
+            check( Day10::getSumOfSignalStrengths( operations ), Day10::getSumOfSignalStrengths( trace ), name + " signal strengths" );
+            check( Day10::getScreenAfterOperations( operations ), Day10::getScreen( trace ), name + " screen" );
+
+            int64_t X = 1;
+            int64_t cycle = 1;
+            for( auto& operation : operations ) {
+                const auto previousX = X;
+                const auto cyclesExecuted = std::visit( [&] ( auto& operation ) { return Day10::executeCommand( operation, X ); }, operation );
+                for( int64_t end = cycle + cyclesExecuted; cycle < end; cycle++ )
+                    check( previousX, trace.getX( cycle ), name + fmt::format( " X in cycle {}", cycle ) );
+            }
+            check( cycle - 1, trace.getNumCycles(), name + " number of cycles" );
+            for( int64_t after : { 0, 1, 100 } )
+                check( X, trace.getX( cycle + after ), name + fmt::format( " X {} cycles after the end", after ) );
+
+            const std::vector<int64_t> checkCycles = { cycle, cycle + 40 };
+            check( ( 2 * cycle + 40 ) * X, Day10::getSumOfSignalStrengths( trace, checkCycles ), name + " signal strengths after the end" );
+        }
+
+        const Day10::CycleTrace trace( generateProgram( random, 10 ) );
+        for( int64_t cycle : { 0, -1, -40 } ) {
+            bool threw = false;
+            try {
+                trace.getX( cycle );
+            }
+            catch( const std::runtime_error& ) {
+                threw = true;
+            }
+            check( 1, threw, fmt::format( "cycle {} throws", cycle ) );
+        }
+    }
+
+    // Batches mixing empty, short and long programs, so lanes finish on different cycles and
+    // rows, against evaluating every program on its own
+    void testEvaluatePrograms() {
+        std::mt19937 random( 46 );
+        for( int64_t i = 0; i < 50; i++ ) {
+            std::vector<std::vector<Day10::Operation>> programs;
+            const int64_t numPrograms = random() % ( 3 * Day10::laneCount );
+            for( int64_t program = 0; program < numPrograms; program++ )
+                programs.push_back( generateProgram( random, random() % 4 == 0 ? random() % 3 : random() % 400 ) );
+
+            const auto results = Day10::evaluatePrograms( programs );
+            check( numPrograms, std::ssize( results ), fmt::format( "batch {} number of results", i ) );
+            for( int64_t program = 0; program < std::min( numPrograms, std::ssize( results ) ); program++ ) {
+                const auto name = fmt::format( "batch {} program {}", i, program );
+                check( Day10::CycleTrace( programs[ program ] ).getNumCycles(), results[ program ].numCycles, name + " number of cycles" );
+                check( Day10::getSumOfSignalStrengths( programs[ program ] ), results[ program ].signalStrengthSum, name + " signal strengths" );
+                check( Day10::getScreenAfterOperations( programs[ program ] ), Day10::getScreen( results[ program ] ), name + " screen" );
+            }
+        }
+    }
+}
+
+int main() {
+    testCycleTrace();
+    testEvaluatePrograms();
+
+    if( numFailures > 0 ) {
+        fmt::print( "Day10Test: {} checks failed\n", numFailures );
+        return 1;
+    }
+    fmt::print( "Day10Test: all checks passed\n" );
+    return 0;
+}
@@ -0,0 +1,183 @@
+#include "../Challenge/Day11.h"
+
+#include <sstream>
+
+namespace
+{
+    int64_t numFailures = 0;
+
+    template<typename T>
+    void check( const T& expected, const T& actual, const std::string& name ) {
+        if( expected == actual )
+            return;
+        fmt::print( "FAILED {}\n", name );
+        numFailures++;
+    }
+
+    // The example troop of the puzzle
+    constexpr std::string_view exampleInput =
+        "Monkey 0:\n"
+        "  Starting items: 79, 98\n"
+        "  Operation: new = old * 19\n"
+        "  Test: divisible by 23\n"
+        "    If true: throw to monkey 2\n"
+        "    If false: throw to monkey 3\n"
+        "\n"
+        "Monkey 1:\n"
+        "  Starting items: 54, 65, 75, 74\n"
+        "  Operation: new = old + 6\n"
+        "  Test: divisible by 19\n"
+        "    If true: throw to monkey 2\n"
+        "    If false: throw to monkey 0\n"
+        "\n"
+        "Monkey 2:\n"
+        "  Starting items: 79, 60, 97\n"
+        "  Operation: new = old * old\n"
+        "  Test: divisible by 13\n"
+        "    If true: throw to monkey 1\n"
+        "    If false: throw to monkey 3\n"
+        "\n"
+        "Monkey 3:\n"
+        "  Starting items: 74\n"
+        "  Operation: new = old + 3\n"
+        "  Test: divisible by 17\n"
+        "    If true: throw to monkey 0\n"
+        "    If false: throw to monkey 1\n";
+
+    std::vector<Day11::Monkey> parseMonkeys( std::string_view input ) {
+        std::istringstream stream{ std::string( input ) };
+        return Day11::parseInput( stream );
+    }
+
+    void testExample() {
+        const auto monkeys = parseMonkeys( exampleInput );
+        const Day11::MonkeyProgram program( monkeys );
+        check( int64_t( 10605 ), Day11::getTopMonkeysScore( monkeys, 20, Day11::getCommonDenominator( monkeys ), true ), "reference part one" );
+        check( int64_t( 2713310158 ), Day11::getTopMonkeysScore( monkeys, 10'000, Day11::getCommonDenominator( monkeys ), false ), "reference part two" );
+
+        for( auto engine : { Day11::Engine::RoundByRound, Day11::Engine::PerItem, Day11::Engine::PerItemParallel } ) {
+            check( std::string( "10605" ), Day11::toString( Day11::getTopMonkeysScore( program, 20, true, engine ) ), "part one" );
+            check( std::string( "2713310158" ), Day11::toString( Day11::getTopMonkeysScore( program, 10'000, false, engine ) ), "part two" );
+        }
+    }
+
+    // Cycle extrapolation against round by round simulation, and a round count whose
+    // monkey business needs more than 64 bits
+    void testHugeRoundCounts() {
+        const Day11::MonkeyProgram program( parseMonkeys( exampleInput ) );
+        for( int64_t rounds : { 1, 7, 1000, 12'345, 100'000 } )
+            check( program.getInspectionCounts( rounds, false ), Day11::getInspectionCountsPerItem( program, rounds, false ), "per item counts" );
+
+        const std::vector<int64_t> expectedCounts = { 5217653508757, 4782346491239, 193256578955, 5202028508760 };
+        check( expectedCounts, Day11::getInspectionCountsPerItem( program, 1'000'000'000'000, false ), "counts of 10^12 rounds" );
+        check( std::string( "27142382301385558311211320" ),
+            Day11::toString( Day11::getTopMonkeysScore( program, 1'000'000'000'000, false, Day11::Engine::PerItem ) ), "monkey business of 10^12 rounds" );
+    }
+
+    // Test values whose product does not fit a common modulus. Part two falls back to one residue
+    // per test value, part one is not supported and throws.
+    std::string replaceTestValues( std::vector<std::string> testValues ) {
+        std::string input( exampleInput );
+        size_t position = 0;
+        for( auto& testValue : testValues ) {
+            position = input.find( "by ", position ) + 3;
+            input.replace( position, input.find( '\n', position ) - position, testValue );
+        }
+        return input;
+    }
+
+    // Round by round part two with the worry levels kept modulo the product of all test values
+    // in 128 bits, independent of MonkeyProgram
+    std::vector<int64_t> getNaiveInspectionCounts( const std::vector<Day11::Monkey>& monkeys, int64_t rounds ) {
+        using Worry = unsigned __int128;
+        Worry modulus = 1;
+        for( auto& monkey : monkeys )
+            modulus *= static_cast<Worry>( monkey.test.testValue );
+
+        // Double and add, so products of two residues never overflow
+        auto multiply = [&] ( Worry a, Worry b ) {
+            Worry product = 0;
+            for( a %= modulus; b > 0; b >>= 1 ) {
+                if( b & 1 )
+                    product = product >= modulus - a ? product - ( modulus - a ) : product + a;
+                a = a >= modulus - a ? a - ( modulus - a ) : a + a;
+            }
+            return product;
+        };
+
+        std::vector<std::vector<Worry>> items;
+        for( auto& monkey : monkeys )
+            items.push_back( monkey.items | ranges::views::transform( [] ( int64_t item ) { return static_cast<Worry>( item ); } ) | ranges::to_vector );
+
+        std::vector<int64_t> counts( monkeys.size() );
+        for( int64_t round = 0; round < rounds; round++ ) {
+            for( size_t index = 0; index < monkeys.size(); index++ ) {
+                auto& monkey = monkeys[ index ];
+                for( auto worry : items[ index ] ) {
+                    switch( monkey.operation.kind ) {
+                    case Day11::OperationKind::Add:
+                        worry = ( worry + static_cast<Worry>( monkey.operation.constant ) ) % modulus;
+                        break;
+                    case Day11::OperationKind::Multiply:
+                        worry = multiply( worry, static_cast<Worry>( monkey.operation.constant ) );
+                        break;
+                    case Day11::OperationKind::Square:
+                        worry = multiply( worry, worry );
+                        break;
+                    }
+                    const auto target = worry % static_cast<Worry>( monkey.test.testValue ) == 0 ? monkey.test.trueMonkey : monkey.test.falseMonkey;
+                    items[ target ].push_back( worry );
+                }
+                counts[ index ] += std::ssize( items[ index ] );
+                items[ index ].clear();
+            }
+        }
+        return counts;
+    }
+
+    void testLargeTestValues() {
+        auto exampleCounts = getNaiveInspectionCounts( parseMonkeys( exampleInput ), 10'000 );
+        ranges::sort( exampleCounts, std::greater() );
+        check( int64_t( 2713310158 ), exampleCounts[ 0 ] * exampleCounts[ 1 ], "naive part two of the example" );
+
+        // Below the limit the residues per test value agree with the common modulus
+        const Day11::MonkeyProgram fittingProgram( parseMonkeys( replaceTestValues( { "32749", "32719", "32717", "32713" } ) ) );
+        check( fittingProgram.getInspectionCounts( 10'000, false ), fittingProgram.getInspectionCountsPerDivisor( 10'000 ), "per divisor counts" );
+
+        const auto monkeys = parseMonkeys( replaceTestValues( { "1000000007", "998244353", "1000000009", "999999937" } ) );
+        const Day11::MonkeyProgram program( monkeys );
+        check( false, program.hasWorryModulus(), "no common modulus" );
+
+        auto expectedCounts = getNaiveInspectionCounts( monkeys, 10'000 );
+        check( expectedCounts, program.getInspectionCountsPerDivisor( 10'000 ), "per divisor counts of large test values" );
+        check( expectedCounts, Day11::getInspectionCountsPerItem( program, 10'000, false ), "per item counts of large test values" );
+
+        ranges::sort( expectedCounts, std::greater() );
+        const auto expected = fmt::format( "{}", expectedCounts[ 0 ] * expectedCounts[ 1 ] );
+        for( auto engine : { Day11::Engine::RoundByRound, Day11::Engine::PerItem, Day11::Engine::PerItemParallel } ) {
+            check( expected, Day11::toString( Day11::getTopMonkeysScore( program, 10'000, false, engine ) ), "part two of large test values" );
+
+            bool threw = false;
+            try {
+                Day11::getTopMonkeysScore( program, 20, true, engine );
+            }
+            catch( const std::runtime_error& ) {
+                threw = true;
+            }
+            check( true, threw, "part one of large test values throws" );
+        }
+    }
+}
+
+int main() {
+    testExample();
+    testHugeRoundCounts();
+    testLargeTestValues();
+
+    if( numFailures > 0 ) {
+        fmt::print( "Day11Test: {} checks failed\n", numFailures );
+        return 1;
+    }
+    fmt::print( "Day11Test: all checks passed\n" );
+    return 0;
+}
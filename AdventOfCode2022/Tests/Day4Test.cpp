@@ -0,0 +1,97 @@
+#include "../Challenge/Day4.h"
+
+#include <random>
+
+namespace
+{
+    int64_t numFailures = 0;
+
+    void check( int64_t expected, int64_t actual, const std::string& name ) {
+        if( expected == actual )
+            return;
+        fmt::print( "FAILED {}: expected {}, got {}\n", name, expected, actual );
+        numFailures++;
+    }
+
+    std::vector<Day4::CleanPair> generatePairs( std::mt19937& random, int64_t numPairs, int64_t maxSection ) {
+        auto generateSections = [&] {
+            const int64_t first = random() % ( maxSection + 1 );
+            const int64_t second = random() % ( maxSection + 1 );
+            return Day4::Sections{ std::min( first, second ), std::max( first, second ) };
+        };
+
+        std::vector<Day4::CleanPair> pairs;
+        for( int64_t i = 0; i < numPairs; i++ )
+            pairs.push_back( { generateSections(), generateSections() } );
+        return pairs;
+    }
+
+    Day4::SectionColumns getColumns( const std::vector<Day4::CleanPair>& pairs ) {
+        Day4::SectionColumns columns;
+        for( auto& pair : pairs ) {
+            columns.firstMin.push_back( static_cast<uint32_t>( pair.firstSections.min ) );
+            columns.firstMax.push_back( static_cast<uint32_t>( pair.firstSections.max ) );
+            columns.secondMin.push_back( static_cast<uint32_t>( pair.secondSections.min ) );
+            columns.secondMax.push_back( static_cast<uint32_t>( pair.secondSections.max ) );
+        }
+        return columns;
+    }
+
+    // Column kernel against the per pair overlap checks
+    void testCountOverlaps() {
+        std::mt19937 random( 4 );
+        for( int64_t i = 0; i < 200; i++ ) {
+            const auto pairs = generatePairs( random, random() % 300, 1 + random() % 100 );
+            const auto counts = Day4::countOverlaps( getColumns( pairs ) );
+            check( Day4::getNumberOfCompleteOverlapping( pairs ), counts.complete, fmt::format( "complete overlaps {}", i ) );
+            check( Day4::getNumberOfPartlyOverlapping( pairs ), counts.partly, fmt::format( "partly overlaps {}", i ) );
+        }
+    }
+
+    // Section index against comparing all assignments with each other
+    void testSectionIndex() {
+        std::mt19937 random( 44 );
+        for( int64_t i = 0; i < 200; i++ ) {
+            const int64_t maxSection = 1 + random() % 100;
+            const auto pairs = generatePairs( random, random() % 150, maxSection );
+            const Day4::SectionIndex index( getColumns( pairs ) );
+            const auto name = fmt::format( "section index {}", i );
+
+            std::vector<std::pair<int64_t, Day4::Sections>> assignments;
+            for( int64_t line = 0; line < std::ssize( pairs ); line++ ) {
+                assignments.push_back( { line, pairs[ line ].firstSections } );
+                assignments.push_back( { line, pairs[ line ].secondSections } );
+            }
+
+            int64_t crossPairs = 0;
+            for( size_t a = 0; a < assignments.size(); a++ )
+                for( size_t b = a + 1; b < assignments.size(); b++ )
+                    if( assignments[ a ].first != assignments[ b ].first &&
+                        Day4::isPartlyOverlap( { assignments[ a ].second, assignments[ b ].second } ) )
+                        crossPairs++;
+            check( crossPairs, index.getNumOverlappingCrossPairs(), name + " cross pairs" );
+
+            int64_t maxCoverage = 0;
+            for( int64_t section = -1; section <= maxSection + 1; section++ ) {
+                const auto coverage = ranges::count_if( assignments, [&] ( const auto& assignment ) {
+                    return assignment.second.min <= section && section <= assignment.second.max;
+                } );
+                check( coverage, index.getCoverage( section ), name + fmt::format( " coverage of {}", section ) );
+                maxCoverage = std::max<int64_t>( maxCoverage, coverage );
+            }
+            check( maxCoverage, index.getMaxCoverage(), name + " max coverage" );
+        }
+    }
+}
+
+int main() {
+    testCountOverlaps();
+    testSectionIndex();
+
+    if( numFailures > 0 ) {
+        fmt::print( "Day4Test: {} checks failed\n", numFailures );
+        return 1;
+    }
+    fmt::print( "Day4Test: all checks passed\n" );
+    return 0;
+}
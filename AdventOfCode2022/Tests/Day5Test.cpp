@@ -0,0 +1,139 @@
+#include "../Challenge/Day5.h"
+
+#include <random>
+#include <sstream>
+
+namespace
+{
+    int64_t numFailures = 0;
+
+    void check( const std::string& expected, const std::string& actual, const std::string& name ) {
+        if( expected == actual )
+            return;
+        fmt::print( "FAILED {}: expected {}, got {}\n", name, expected, actual );
+        numFailures++;
+    }
+
+    // Random cargo with valid moves, by default every stack stays non-empty
+    Day5::CargoSetup generateSetup( std::mt19937& random, bool allowEmptyStacks = false ) {
+        const int64_t numStacks = 1 + random() % 9;
+        Day5::CargoSetup setup;
+        setup.cargo.resize( numStacks );
+        for( auto& stack : setup.cargo )
+            for( int64_t i = 0, height = 1 + random() % 8; i < height; i++ )
+                stack.push_back( static_cast<char>( 'A' + random() % 26 ) );
+
+        if( numStacks == 1 )
+            return setup;
+
+        std::vector<int64_t> heights;
+        for( auto& stack : setup.cargo )
+            heights.push_back( std::ssize( stack ) );
+
+        for( int64_t i = 0, numMoves = random() % 200; i < numMoves; i++ ) {
+            const int64_t from = random() % numStacks;
+            const int64_t to = ( from + 1 + random() % ( numStacks - 1 ) ) % numStacks;
+            const int64_t maxCount = allowEmptyStacks ? heights[ from ] : heights[ from ] - 1;
+            if( maxCount < 1 )
+                continue;
+            const int64_t count = 1 + random() % maxCount;
+            setup.moves.push_back( { count, from, to } );
+            heights[ from ] -= count;
+            heights[ to ] += count;
+        }
+        return setup;
+    }
+
+    void testExample() {
+        std::istringstream input(
+            "    [D]    \n"
+            "[N] [C]    \n"
+            "[Z] [M] [P]\n"
+            " 1   2   3 \n"
+            "\n"
+            "move 1 from 2 to 1\n"
+            "move 3 from 1 to 3\n"
+            "move 2 from 2 to 1\n"
+            "move 1 from 1 to 2" );
+        const auto setup = Day5::parseInput( input );
+
+        for( auto solver : { Day5::Solver::ForwardSimulation, Day5::Solver::BackwardTracking } ) {
+            check( "CMZ", Day5::getTopCargo( setup, Day5::Crane::CrateMover9000, solver ), "example CrateMover9000" );
+            check( "MCD", Day5::getTopCargo( setup, Day5::Crane::CrateMover9001, solver ), "example CrateMover9001" );
+        }
+    }
+
+    // Backward tracking against forward simulation for both cranes, with the original
+    // deque based simulation as the reference
+    void testBackwardMatchesForward() {
+        std::mt19937 random( 5 );
+        for( int64_t i = 0; i < 2000; i++ ) {
+            const auto setup = generateSetup( random );
+            const auto name = fmt::format( "random setup {}", i );
+
+            const auto expected9000 = Day5::getTopCargo( setup );
+            check( expected9000, Day5::getTopCargo( setup, Day5::Crane::CrateMover9000, Day5::Solver::ForwardSimulation ), name + " forward 9000" );
+            check( expected9000, Day5::getTopCargo( setup, Day5::Crane::CrateMover9000, Day5::Solver::BackwardTracking ), name + " backward 9000" );
+            check( expected9000, Day5::getTopCargoBulk<Day5::ChunkedStack>( setup, Day5::Crane::CrateMover9000 ), name + " chunked 9000" );
+
+            const auto expected9001 = Day5::getTopCargoAdvanced( setup );
+            check( expected9001, Day5::getTopCargo( setup, Day5::Crane::CrateMover9001, Day5::Solver::ForwardSimulation ), name + " forward 9001" );
+            check( expected9001, Day5::getTopCargo( setup, Day5::Crane::CrateMover9001, Day5::Solver::BackwardTracking ), name + " backward 9001" );
+            check( expected9001, Day5::getTopCargoBulk<Day5::ChunkedStack>( setup, Day5::Crane::CrateMover9001 ), name + " chunked 9001" );
+        }
+    }
+
+    // History queries against replaying the first moves on the deque stacks, empty stacks skipped
+    void testCargoHistory() {
+        std::mt19937 random( 30 );
+        for( int64_t i = 0; i < 300; i++ ) {
+            const auto setup = generateSetup( random, true );
+            for( auto crane : { Day5::Crane::CrateMover9000, Day5::Crane::CrateMover9001 } ) {
+                for( int64_t checkpointInterval : { 1, 2, 7, 64 } ) {
+                    const Day5::CargoHistory history( setup, crane, checkpointInterval );
+                    auto cargo = setup.cargo;
+                    for( int64_t moveCount = 0; moveCount <= std::ssize( setup.moves ); moveCount++ ) {
+                        if( moveCount > 0 ) {
+                            if( crane == Day5::Crane::CrateMover9000 )
+                                Day5::executeMove( cargo, setup.moves[ moveCount - 1 ] );
+                            else
+                                Day5::executeMoveAdvanced( cargo, setup.moves[ moveCount - 1 ] );
+                        }
+
+                        std::string expected;
+                        for( auto& stack : cargo )
+                            if( !stack.empty() )
+                                expected += stack.back();
+
+                        const auto name = fmt::format( "history {} interval {} after {} moves", i, checkpointInterval, moveCount );
+                        check( expected, history.getTopCargoAfter( moveCount ), name );
+                        for( int64_t stack = 0; stack < std::ssize( cargo ); stack++ )
+                            check( std::to_string( cargo[ stack ].size() ), std::to_string( history.getStackHeightAfter( stack, moveCount ) ), name + " height" );
+                    }
+                }
+            }
+        }
+
+        bool threw = false;
+        try {
+            Day5::CargoHistory( generateSetup( random ), Day5::Crane::CrateMover9000, 0 );
+        }
+        catch( const std::runtime_error& ) {
+            threw = true;
+        }
+        check( "true", threw ? "true" : "false", "checkpoint interval 0 throws" );
+    }
+}
+
+int main() {
+    testExample();
+    testBackwardMatchesForward();
+    testCargoHistory();
+
+    if( numFailures > 0 ) {
+        fmt::print( "Day5Test: {} checks failed\n", numFailures );
+        return 1;
+    }
+    fmt::print( "Day5Test: all checks passed\n" );
+    return 0;
+}
@@ -0,0 +1,326 @@
+#include "../Challenge/Day7.h"
+
+#include <random>
+#include <set>
+#include <sstream>
+
+namespace
+{
+    int64_t numFailures = 0;
+
+    template<typename T>
+    void check( const T& expected, const T& actual, const std::string& name ) {
+        if( expected == actual )
+            return;
+        fmt::print( "FAILED {}\n", name );
+        numFailures++;
+    }
+
+    // Random transcript of a depth-first walk, every directory gets a file f0.txt
+    std::string generateTranscript( std::mt19937& random, int64_t maxWidth, int64_t maxDepth ) {
+        std::ostringstream transcript;
+        transcript << "$ cd /\n";
+        std::function<void( int64_t )> listDirectory = [&] ( int64_t depth ) {
+            transcript << "$ ls\n";
+            const int64_t width = depth >= maxDepth ? 0 : random() % ( maxWidth + 1 );
+            for( int64_t i = 0; i < width; i++ )
+                transcript << "dir d" << i << "\n";
+            for( int64_t i = 0, numFiles = 1 + random() % 3; i < numFiles; i++ )
+                transcript << random() % 200'000 << " f" << i << ".txt\n";
+            for( int64_t i = 0; i < width; i++ ) {
+                transcript << "$ cd d" << i << "\n";
+                listDirectory( depth + 1 );
+                transcript << "$ cd ..\n";
+            }
+        };
+        listDirectory( 0 );
+        return transcript.str();
+    }
+
+    void testSizeMultiset() {
+        std::mt19937_64 random( 9 );
+        Day7::SizeMultiset sizes;
+        std::multiset<int64_t> reference;
+        for( int64_t i = 0; i < 20'000; i++ ) {
+            const int64_t value = random() % 2 ? random() % 1000 : random() % ( 1ll << 40 );
+            if( random() % 3 < 2 ) {
+                sizes.insert( value );
+                reference.insert( value );
+            }
+            else if( !reference.empty() ) {
+                auto it = reference.lower_bound( value );
+                if( it == reference.end() )
+                    it = reference.begin();
+                sizes.erase( *it );
+                reference.erase( it );
+            }
+
+            const int64_t query = random() % 3 == 0 ? random() % 1200 : static_cast<int64_t>( random() >> 1 );
+            int64_t sum = 0;
+            for( auto size : reference )
+                if( size <= query )
+                    sum += size;
+            check( sum, sizes.getSumAtMost( query ), "sum at most" );
+
+            const auto it = reference.lower_bound( query );
+            check( it == reference.end() ? std::nullopt : std::optional<int64_t>( *it ), sizes.getSmallestAtLeast( query ), "smallest at least" );
+        }
+
+        Day7::SizeMultiset small;
+        small.insert( 5 );
+        small.insert( 100 );
+        check( int64_t( 105 ), small.getSumAtMost( 1ll << 62 ), "sum above the value range" );
+        check( std::optional<int64_t>(), small.getSmallestAtLeast( 1ll << 62 ), "smallest above the value range" );
+    }
+
+    // Random file events, the index must agree with a full recalculation of its own tree
+    void testDirectorySizeIndex() {
+        std::mt19937 random( 3 );
+        for( int64_t i = 0; i < 50; i++ ) {
+            std::istringstream transcript( generateTranscript( random, 1 + i % 5, 2 + i % 6 ) );
+            Day7::DirectorySizeIndex index( Day7::parseTree( transcript ) );
+            const auto numDirectories = std::ssize( index.getTree().directories );
+
+            std::vector<std::pair<int64_t, std::string>> addedFiles;
+            for( int64_t event = 0; event < 300; event++ ) {
+                const auto operation = random() % 3;
+                if( operation == 0 || addedFiles.empty() ) {
+                    const int64_t directory = random() % numDirectories;
+                    const auto name = fmt::format( "new{}.txt", event );
+                    index.addFile( directory, name, random() % 50'000 );
+                    addedFiles.emplace_back( directory, name );
+                }
+                else if( operation == 1 ) {
+                    const auto& [directory, name] = addedFiles[ random() % addedFiles.size() ];
+                    index.setFileSize( directory, name, random() % 50'000 );
+                }
+                else {
+                    const auto file = addedFiles.begin() + random() % addedFiles.size();
+                    index.removeFile( file->first, file->second );
+                    addedFiles.erase( file );
+                }
+
+                auto tree = index.getTree();
+                std::vector<int64_t> liveSizes;
+                for( auto& directory : tree.directories )
+                    liveSizes.push_back( directory.size );
+                Day7::calculateDirectorySizes( tree );
+                for( int64_t directory = 0; directory < numDirectories; directory++ )
+                    check( liveSizes[ directory ], tree.directories[ directory ].size, "directory size" );
+
+                for( int64_t size : { 0, 1000, 100'000, 400'000, 3'000'000 } ) {
+                    check( Day7::calculateSumOfDirectories( tree, size ), index.getSumOfDirectories( size ), "sum of directories" );
+                    check( Day7::getSizeOfDeletedDirectory( tree, size ), index.getSizeOfDeletedDirectory( size ), "deleted directory" );
+                }
+            }
+        }
+    }
+
+    std::string toTranscript( const std::vector<Day7::Command>& commands ) {
+        std::string transcript;
+        for( auto& command : commands ) {
+            if( auto changeDirectory = std::get_if<Day7::ChangeDirectory>( &command ) ) {
+                transcript += "$ cd " + changeDirectory->path + "\n";
+                continue;
+            }
+
+            transcript += "$ ls\n";
+            for( auto& entry : std::get<Day7::ListDirectory>( command ).results ) {
+                if( auto file = std::get_if<Day7::FileInfo>( &entry ) )
+                    transcript += fmt::format( "{} {}\n", file->size, file->name );
+                else
+                    transcript += "dir " + std::get<Day7::DirectoryInfo>( entry ).name + "\n";
+            }
+        }
+        return transcript;
+    }
+
+    std::vector<int64_t> getSortedSizes( Day7::Directory& root ) {
+        std::vector<int64_t> sizes;
+        std::function<void( Day7::Directory& )> collectSizes = [&] ( Day7::Directory& directory ) {
+            sizes.push_back( Day7::calculateDirectorySize( directory ) );
+            for( auto& subDirectory : directory.subDirectories )
+                collectSizes( subDirectory.second );
+        };
+        collectSizes( root );
+        ranges::sort( sizes );
+        return sizes;
+    }
+
+    std::vector<int64_t> getSortedSizes( Day7::FlatTree& tree ) {
+        Day7::calculateDirectorySizes( tree );
+        std::vector<int64_t> sizes;
+        for( auto& directory : tree.directories )
+            sizes.push_back( directory.size );
+        ranges::sort( sizes );
+        return sizes;
+    }
+
+    // Random walks over a hidden file system that enter directories before or without listing
+    // them, the flat trees must agree with the reference tree
+    void testUnlistedDirectories() {
+        const std::vector<Day7::Command> example = {
+            Day7::ChangeDirectory{ "/" }, Day7::ChangeDirectory{ "a" }, Day7::ListDirectory{ { Day7::FileInfo{ "x.txt", 100 } } } };
+        auto exampleRoot = Day7::buildTree( example );
+        check( std::vector<int64_t>{ 100, 100 }, getSortedSizes( exampleRoot ), "cd into unlisted directory" );
+
+        std::mt19937 random( 34 );
+        for( int64_t i = 0; i < 500; i++ ) {
+            struct HiddenDirectory
+            {
+                int64_t parent = -1;
+                std::vector<int64_t> children;
+                std::vector<Day7::ListResult> listing;
+            };
+            std::vector<HiddenDirectory> fileSystem( 1 );
+            for( int64_t directory = 1, numDirectories = 1 + random() % 30; directory < numDirectories; directory++ ) {
+                const int64_t parent = random() % directory;
+                fileSystem[ parent ].children.push_back( directory );
+                fileSystem[ parent ].listing.push_back( Day7::DirectoryInfo{ fmt::format( "d{}", directory ) } );
+                fileSystem.push_back( { parent } );
+            }
+            for( auto& directory : fileSystem ) {
+                for( int64_t file = 0, numFiles = 1 + random() % 3; file < numFiles; file++ )
+                    directory.listing.push_back( Day7::FileInfo{ fmt::format( "f{}.txt", file ), static_cast<int64_t>( random() % 100'000 ) } );
+                std::shuffle( directory.listing.begin(), directory.listing.end(), random );
+            }
+
+            std::vector<Day7::Command> commands = { Day7::ChangeDirectory{ "/" } };
+            int64_t current = 0;
+            for( int64_t step = 0, numSteps = random() % 80; step < numSteps; step++ ) {
+                const auto operation = random() % 6;
+                if( operation < 3 && !fileSystem[ current ].children.empty() ) {
+                    current = fileSystem[ current ].children[ random() % fileSystem[ current ].children.size() ];
+                    commands.push_back( Day7::ChangeDirectory{ fmt::format( "d{}", current ) } );
+                }
+                else if( operation == 3 && current != 0 ) {
+                    current = fileSystem[ current ].parent;
+                    commands.push_back( Day7::ChangeDirectory{ ".." } );
+                }
+                else if( operation == 4 ) {
+                    current = 0;
+                    commands.push_back( Day7::ChangeDirectory{ "/" } );
+                }
+                else
+                    commands.push_back( Day7::ListDirectory{ fileSystem[ current ].listing } );
+            }
+
+            auto root = Day7::buildTree( commands );
+            const auto expected = getSortedSizes( root );
+            const auto name = fmt::format( "random walk {}", i );
+            auto flatTree = Day7::buildFlatTree( commands );
+            check( expected, getSortedSizes( flatTree ), name + " command list" );
+
+            std::istringstream transcript( toTranscript( commands ) );
+            auto tree = Day7::parseTree( transcript );
+            check( expected, getSortedSizes( tree ), name + " transcript" );
+
+            // Every directory must be the parent of exactly its own children range
+            for( int64_t directory = 0; directory < std::ssize( tree.directories ); directory++ ) {
+                int64_t subtreeDirectories = 1;
+                for( int64_t child = tree.directories[ directory ].firstChild; child < tree.directories[ directory ].firstChild + tree.directories[ directory ].numChildren; child++ ) {
+                    check( directory, tree.directories[ child ].parent, name + " children range" );
+                    subtreeDirectories += tree.directories[ child ].subtreeDirectories;
+                }
+                check( subtreeDirectories, tree.directories[ directory ].subtreeDirectories, name + " subtree directories" );
+            }
+            check( std::ssize( tree.directories ) - 1, ranges::accumulate( tree.directories, int64_t( 0 ), ranges::plus(), &Day7::FlatDirectory::numChildren ), name + " number of children" );
+        }
+    }
+
+    // Tree from a parent array with parents[ i ] < i, listed depth first with one file per directory
+    Day7::FlatTree buildTree( const std::vector<int64_t>& parents, std::mt19937& random ) {
+        std::vector<std::vector<int64_t>> children( parents.size() );
+        for( int64_t directory = 1; directory < std::ssize( parents ); directory++ )
+            children[ parents[ directory ] ].push_back( directory );
+
+        Day7::FlatTreeBuilder builder;
+        auto listDirectory = [&] ( int64_t directory ) {
+            builder.listDirectory();
+            for( auto child : children[ directory ] )
+                builder.addListedDirectory( fmt::format( "d{}", child ) );
+            builder.addListedFile( "f.txt", random() % 100'000 );
+        };
+
+        listDirectory( 0 );
+        std::vector<std::pair<int64_t, size_t>> stack{ { 0, 0 } };
+        while( !stack.empty() ) {
+            auto& [directory, nextChild] = stack.back();
+            if( nextChild == children[ directory ].size() ) {
+                stack.pop_back();
+                if( !stack.empty() )
+                    builder.changeDirectory( ".." );
+                continue;
+            }
+
+            const auto child = children[ directory ][ nextChild++ ];
+            builder.changeDirectory( fmt::format( "d{}", child ) );
+            listDirectory( child );
+            stack.push_back( { child, 0 } );
+        }
+        return builder.build();
+    }
+
+    // Parallel aggregation against the serial size calculation, on a root with many leaves and
+    // one large child, on long chains and on random trees
+    void testAggregateDirectorySizes() {
+        std::mt19937 random( 36 );
+        std::vector<std::pair<std::string, std::vector<int64_t>>> shapes;
+
+        std::vector<int64_t> wide( 1001, 0 );
+        for( int64_t directory = 1001; directory < 60'000; directory++ )
+            wide.push_back( directory == 1001 ? 0 : 1001 + random() % ( directory - 1001 ) );
+        shapes.emplace_back( "wide", std::move( wide ) );
+
+        std::vector<int64_t> deep( 1, 0 );
+        for( int64_t directory = 1; directory < 40'000; directory++ )
+            deep.push_back( directory <= 4 ? 0 : directory - 4 );
+        shapes.emplace_back( "deep", std::move( deep ) );
+
+        for( int64_t i = 0; i < 5; i++ ) {
+            std::vector<int64_t> parents( 1, 0 );
+            for( int64_t directory = 1, numDirectories = 1 + random() % 20'000; directory < numDirectories; directory++ )
+                parents.push_back( random() % directory );
+            shapes.emplace_back( fmt::format( "random {}", i ), std::move( parents ) );
+        }
+
+        for( auto& [name, parents] : shapes ) {
+            auto tree = buildTree( parents, random );
+            Day7::calculateDirectorySizes( tree );
+            std::vector<int64_t> expectedSizes;
+            for( auto& directory : tree.directories )
+                expectedSizes.push_back( directory.size );
+            const Day7::SizeQuery query = { 100'000, tree.directories[ 0 ].size / 3 };
+            const auto expectedSum = Day7::calculateSumOfDirectories( tree, query.maxSize );
+            const auto expectedDeleted = Day7::getSizeOfDeletedDirectory( tree, query.sizeNeeded );
+
+            for( int64_t numThreads : { 1, 2, 3, 8 } ) {
+                for( auto& directory : tree.directories )
+                    directory.size = 0;
+                const auto summary = Day7::aggregateDirectorySizes( tree, query, numThreads );
+                const auto testName = fmt::format( "{} with {} threads", name, numThreads );
+                check( expectedSum, summary.sumOfDirectories, testName + " sum of directories" );
+                check( expectedDeleted, summary.sizeOfDeletedDirectory, testName + " deleted directory" );
+
+                std::vector<int64_t> sizes;
+                for( auto& directory : tree.directories )
+                    sizes.push_back( directory.size );
+                check( expectedSizes, sizes, testName + " directory sizes" );
+            }
+        }
+    }
+}
+
+int main() {
+    testSizeMultiset();
+    testDirectorySizeIndex();
+    testUnlistedDirectories();
+    testAggregateDirectorySizes();
+
+    if( numFailures > 0 ) {
+        fmt::print( "Day7Test: {} checks failed\n", numFailures );
+        return 1;
+    }
+    fmt::print( "Day7Test: all checks passed\n" );
+    return 0;
+}
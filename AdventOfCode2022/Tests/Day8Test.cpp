@@ -0,0 +1,82 @@
+#include "../Challenge/Day8.h"
+
+#include <random>
+
+namespace
+{
+    int64_t numFailures = 0;
+
+    void check( int64_t expected, int64_t actual, const std::string& name ) {
+        if( expected == actual )
+            return;
+        fmt::print( "FAILED {}: expected {}, got {}\n", name, expected, actual );
+        numFailures++;
+    }
+
+    Day8::TreeMap generateMap( std::mt19937& random, int64_t width, int64_t height ) {
+        Day8::TreeMap treeMap;
+        std::string line( width, '0' );
+        for( int64_t y = 0; y < height; y++ ) {
+            for( auto& tree : line )
+                tree = static_cast<char>( '0' + random() % Day8::numTreeHeights );
+            treeMap.addLine( line );
+        }
+        return treeMap;
+    }
+
+    // Random edits, after each one the model must agree with a full recalculation
+    void testForestModel() {
+        std::mt19937 random( 41 );
+        for( int64_t i = 0; i < 100; i++ ) {
+            const int64_t width = 1 + random() % 12;
+            const int64_t height = 1 + random() % 12;
+            auto treeMap = generateMap( random, width, height );
+            Day8::ForestModel model( treeMap );
+            const auto name = fmt::format( "forest {} ({} x {})", i, width, height );
+            check( Day8::calculateVisibility( treeMap ).count(), model.getNumVisibleTrees(), name + " initial visible trees" );
+            check( Day8::calculateScenicScores( treeMap ).maxScore, model.getMaxTreeScore(), name + " initial max score" );
+
+            for( int64_t edit = 0; edit < 200; edit++ ) {
+                const Day8::Vec2 pos = { static_cast<int64_t>( random() % width ), static_cast<int64_t>( random() % height ) };
+                const auto treeHeight = static_cast<char>( random() % Day8::numTreeHeights );
+                treeMap.set( pos, treeHeight );
+                model.setHeight( pos, treeHeight );
+
+                const auto editName = fmt::format( "{} edit {}", name, edit );
+                check( Day8::calculateVisibility( treeMap ).count(), model.getNumVisibleTrees(), editName + " visible trees" );
+                check( Day8::calculateScenicScores( treeMap ).maxScore, model.getMaxTreeScore(), editName + " max score" );
+            }
+        }
+    }
+
+    // Heights outside 0..9 are rejected and leave the model unchanged
+    void testInvalidHeights() {
+        std::mt19937 random( 42 );
+        const auto treeMap = generateMap( random, 5, 5 );
+        Day8::ForestModel model( treeMap );
+        for( char treeHeight : { -1, 10, 42 } ) {
+            bool threw = false;
+            try {
+                model.setHeight( { 1, 1 }, treeHeight );
+            }
+            catch( const std::runtime_error& ) {
+                threw = true;
+            }
+            check( 1, threw, fmt::format( "height {} throws", int( treeHeight ) ) );
+        }
+        check( Day8::calculateVisibility( treeMap ).count(), model.getNumVisibleTrees(), "visible trees after invalid heights" );
+        check( Day8::calculateScenicScores( treeMap ).maxScore, model.getMaxTreeScore(), "max score after invalid heights" );
+    }
+}
+
+int main() {
+    testForestModel();
+    testInvalidHeights();
+
+    if( numFailures > 0 ) {
+        fmt::print( "Day8Test: {} checks failed\n", numFailures );
+        return 1;
+    }
+    fmt::print( "Day8Test: all checks passed\n" );
+    return 0;
+}
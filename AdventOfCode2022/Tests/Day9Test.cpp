@@ -0,0 +1,123 @@
+#include "../Challenge/Day9.h"
+
+#include <random>
+
+namespace
+{
+    int64_t numFailures = 0;
+
+    void check( int64_t expected, int64_t actual, const std::string& name ) {
+        if( expected == actual )
+            return;
+        fmt::print( "FAILED {}: expected {}, got {}\n", name, expected, actual );
+        numFailures++;
+    }
+
+    Day9::Vec2 getStep( std::mt19937& random ) {
+        constexpr std::array<Day9::Direction, 4> directions = { Day9::Direction::Up, Day9::Direction::Down, Day9::Direction::Left, Day9::Direction::Right };
+        return Day9::getPositionAfterStep( directions[ random() % 4 ], Day9::Vec2() );
+    }
+
+    // Random cells and lines around spread, counted after every few inserts. Lines cross
+    // each other, cover earlier cells and run both ways along both axes.
+    void checkVisitedCells( std::mt19937& random, int64_t numInserts, int64_t spread, int64_t maxLength, const std::string& name ) {
+        Day9::VisitedCells cells;
+        std::set<Day9::Vec2> expected;
+        auto getCoordinate = [&] { return static_cast<int64_t>( random() % ( 2 * spread + 1 ) ) - spread; };
+        for( int64_t i = 0; i < numInserts; i++ ) {
+            const Day9::Vec2 start = { getCoordinate(), getCoordinate() };
+            if( random() % 4 == 0 ) {
+                cells.insert( start );
+                expected.insert( start );
+            }
+            else {
+                const auto step = getStep( random );
+                const int64_t count = random() % ( maxLength + 1 );
+                cells.insertLine( start, step, count );
+                for( int64_t cell = 1; cell <= count; cell++ )
+                    expected.insert( start + Day9::Vec2{ step.x * cell, step.y * cell } );
+            }
+
+            if( random() % 16 == 0 || i + 1 == numInserts )
+                check( std::ssize( expected ), cells.count(), fmt::format( "{} after {} inserts", name, i + 1 ) );
+        }
+    }
+
+    void testVisitedCells() {
+        std::mt19937 random( 9 );
+        for( int64_t i = 0; i < 50; i++ )
+            checkVisitedCells( random, 200, 1 + random() % 300, 200, fmt::format( "dense cells {}", i ) );
+
+        // More lines than are kept before drawing, mostly overlapping on a few rows and columns
+        checkVisitedCells( random, 3 * Day9::VisitedCells::maxStoredRuns, 20, 300, "stored runs" );
+
+        // Cells far enough apart that the bounding box switches to sparse tiles on the way
+        for( int64_t i = 0; i < 10; i++ )
+            checkVisitedCells( random, 300, 100'000, 3000, fmt::format( "sparse cells {}", i ) );
+    }
+
+    // Step by step simulation of every knot with a set of visited cells per knot
+    std::vector<int64_t> getNaiveKnotVisits( const std::vector<Day9::Command>& commands, int64_t ropeLength ) {
+        std::vector<Day9::Vec2> rope( ropeLength );
+        std::vector<std::set<Day9::Vec2>> visits( ropeLength, { Day9::Vec2() } );
+        for( auto& command : commands ) {
+            for( int64_t step = 0; step < command.distance; step++ ) {
+                rope[ 0 ] = Day9::getPositionAfterStep( command.direction, rope[ 0 ] );
+                for( int64_t knot = 1; knot < ropeLength; knot++ )
+                    Day9::updateRopeElement( rope[ knot ], rope[ knot - 1 ] );
+                for( int64_t knot = 0; knot < ropeLength; knot++ )
+                    visits[ knot ].insert( rope[ knot ] );
+            }
+        }
+
+        return visits | ranges::views::transform( [] ( const auto& cells ) { return std::ssize( cells ); } ) | ranges::to_vector;
+    }
+
+    std::vector<Day9::Command> generateCommands( std::mt19937& random, int64_t numCommands, int64_t maxDistance ) {
+        std::vector<Day9::Command> commands;
+        for( int64_t i = 0; i < numCommands; i++ )
+            commands.push_back( { static_cast<Day9::Direction>( random() % 4 ), 1 + static_cast<int64_t>( random() % maxDistance ) } );
+        return commands;
+    }
+
+    void checkKnotVisits( const std::vector<Day9::Command>& commands, int64_t ropeLength, const std::string& name ) {
+        const auto expected = getNaiveKnotVisits( commands, ropeLength );
+        const auto knotVisits = Day9::getNumKnotVisits( commands, ropeLength );
+        check( ropeLength, std::ssize( knotVisits ), name + " number of knots" );
+        for( int64_t knot = 0; knot < std::min( ropeLength, std::ssize( knotVisits ) ); knot++ ) {
+            check( expected[ knot ], knotVisits[ knot ], fmt::format( "{} knot {}", name, knot ) );
+            check( expected[ knot ], Day9::getNumTailVisits( commands, knot + 1 ), fmt::format( "{} tail of length {}", name, knot + 1 ) );
+        }
+    }
+
+    void testKnotVisits() {
+        const std::vector<Day9::Command> example = {
+            { Day9::Direction::Right, 5 }, { Day9::Direction::Up, 8 }, { Day9::Direction::Left, 8 }, { Day9::Direction::Down, 3 },
+            { Day9::Direction::Right, 17 }, { Day9::Direction::Down, 10 }, { Day9::Direction::Left, 25 }, { Day9::Direction::Up, 20 } };
+        check( 36, Day9::getNumKnotVisits( example, 10 )[ 9 ], "example long rope" );
+        checkKnotVisits( example, 10, "example" );
+
+        std::mt19937 random( 44 );
+        for( int64_t i = 0; i < 100; i++ )
+            checkKnotVisits( generateCommands( random, 1 + random() % 100, 1 + random() % 6 ), 1 + random() % 12, fmt::format( "short motions {}", i ) );
+        for( int64_t i = 0; i < 50; i++ )
+            checkKnotVisits( generateCommands( random, 1 + random() % 50, 1 + random() % 300 ), 1 + random() % 12, fmt::format( "long motions {}", i ) );
+
+        // Far enough from the start that the knots switch to sparse tiles
+        auto commands = generateCommands( random, 20, 5000 );
+        commands.insert( commands.begin() + 10, { { Day9::Direction::Right, 70'000 }, { Day9::Direction::Up, 70'000 } } );
+        checkKnotVisits( commands, 4, "sparse motions" );
+    }
+}
+
+int main() {
+    testVisitedCells();
+    testKnotVisits();
+
+    if( numFailures > 0 ) {
+        fmt::print( "Day9Test: {} checks failed\n", numFailures );
+        return 1;
+    }
+    fmt::print( "Day9Test: all checks passed\n" );
+    return 0;
+}